@@ -3,6 +3,13 @@
 #include <string>
 #include <cstdio>
 #include <iostream>
+#include <fstream>
+#include <cstring>
+#include <tuple>
+#include <future>
+#include <random>
+#include <algorithm>
+#include <cmath>
 #include "src/main.hxx"
 
 using namespace std;
@@ -10,30 +17,179 @@ using namespace std;
 
 
 
+/**
+ * Run a technique, report its result, and append it to the output file (if any).
+ * @param x graph the technique runs on
+ * @param r benchmark record, with graph, batch size, repeat and load time filled in
+ * @param technique name of technique
+ * @param threads number of threads used by technique
+ * @param out output file (CSV/JSON), or empty
+ * @param fn technique () => LabelrankResult
+ * @returns result of technique
+ */
+template <class G, class F>
+auto runTechnique(const G& x, BenchmarkRecord r, const char *technique, int threads, const string& out, F fn) {
+  resetPeakMemory();
+  auto a  = fn();
+  auto fc = [&](auto u) { return a.membership[u]; };
+  r.technique  = technique;
+  r.order      = x.order();
+  r.size       = x.size();
+  r.threads    = threads;
+  r.initializationTime = benchmarkStatistics(a.initializationTimes);
+  r.iterationTime      = benchmarkStatistics(a.iterationTimes);
+  r.iterations  = a.iterations;
+  r.updated     = a.updated;
+  r.updates     = a.updates;
+  r.updateTimes = a.updateTimes;
+  r.peakMemory  = peakMemoryBytes();
+  r.modularity  = modularity(x, fc, edgeWeight(x)/2, 1.0f);
+  printf("[%09.3f ms; %09.3f ms init; %03d iters.; %09zu updated; %f modularity] %s\n", a.time, a.initializationTime, a.iterations, a.updated, r.modularity, technique);
+  if (!out.empty()) writeBenchmarkRecord(out, r);
+  return a;
+}
+
+
 template <class G>
-void runExperiment(const G& x, int repeat) {
+void runExperiment(const G& x, const string& graph, const vector<float>& loadTimes, int repeat, const string& out) {
   using K = typename G::key_type;
-  auto M = edgeWeight(x)/2;
-  printf("[original_modularity: %f]\n", modularity(x, M, 1.0f));
-  LabelrankResult<K> a = labelrankSeq<4>(x);
-  printf("[%09.3f ms; %03d iters.] labelrankSeq\n", a.time, a.iterations);
-  auto fc = [&](auto u) { return a.membership[u]; };
-  printf("[modularity: %f]\n", modularity(x, fc, M, 1.0f));
+  using V = typename G::edge_value_type;
+  random_device dev;
+  default_random_engine rnd(dev());
+  vector<Labelset<K, V, 4>> ls;
+  LabelrankOptions o(repeat);
+  LabelrankOptions of(repeat, 500, 1.2f, 0.3f, true);
+  int T = omp_get_max_threads();
+  BenchmarkRecord r = {};
+  r.graph    = graph;
+  r.repeat   = repeat;
+  r.loadTime = benchmarkStatistics(loadTimes);
+  printf("[threads: %d; repeat: %d]\n", T, repeat);
+  printf("[original_modularity: %f]\n", modularity(x, edgeWeight(x)/2, 1.0f));
+  vector<PackedLabelset<K, V, 4>> ps;
+  runTechnique(x, r, "labelrankSeq",         1, out, [&]() { return labelrankSeqW(ls, x, o); });
+  runTechnique(x, r, "labelrankOmp",         T, out, [&]() { return labelrankOmp<4>(x, o); });
+  runTechnique(x, r, "labelrankSeqPacked",   1, out, [&]() { return labelrankSeqW(ps, x, o); });
+  runTechnique(x, r, "labelrankSeqHash",     1, out, [&]() { return labelrankSeq<4, HLabelset>(x, o); });
+  runTechnique(x, r, "labelrankOmpHash",     T, out, [&]() { return labelrankOmp<4, HLabelset>(x, o); });
+  runTechnique(x, r, "labelrankSeqFrontier", 1, out, [&]() { return labelrankSeq<4>(x, of); });
+  // Update graph with a random batch, and find communities again.
+  for (int batchPower=-5; batchPower<=-3; ++batchPower) {
+    size_t batchSize = max(size_t(pow(10.0, batchPower) * x.size()), size_t(1));
+    auto deletions  = randomEdgeDeletions (rnd, x, batchSize/2);
+    auto insertions = randomEdgeInsertions(rnd, x, batchSize/2);
+    OutDiGraph<K, None, V> y; duplicateW(y, x);
+    updateGraphU(y, deletions, insertions, V(1));
+    auto yc = csrGraph(y);
+    auto ms = ls, ns = ls;
+    r.batchSize = batchSize;
+    printf("\n[batch_size: %zu; deletions: %zu; insertions: %zu]\n", batchSize, deletions.size(), insertions.size());
+    runTechnique(yc, r, "labelrankSeqStatic",          1, out, [&]() { return labelrankSeq<4>(yc, o); });
+    runTechnique(yc, r, "labelrankSeqDynamic",         1, out, [&]() { return labelrankSeqDynamic(ms, yc, deletions, insertions, o); });
+    runTechnique(yc, r, "labelrankSeqDynamicFrontier", 1, out, [&]() { return labelrankSeqDynamic(ns, yc, deletions, insertions, of); });
+  }
+}
+
+
+template <class K, class V, class T>
+void runTemporalExperiment(const char *file, size_t batchSize, T window, int repeat, const string& out) {
+  ifstream f(file);
+  OutDiGraph<K, None, V> x;
+  vector<Labelset<K, V, 4>> ls;
+  vector<tuple<K, K, T>> bs, cs;
+  vector<tuple<K, K>> deletions;
+  LabelrankOptions o(repeat);
+  BenchmarkRecord r = {};
+  r.graph  = string(file);
+  r.graph  = r.graph.substr(r.graph.find_last_of('/')+1);
+  r.graph  = r.graph.substr(0, r.graph.find_last_of('.'));
+  r.repeat = repeat;
+  printf("[threads: %d; repeat: %d]\n", 1, repeat);
+  readSnapTemporalBatchW(bs, f, batchSize, window);
+  for (int batch=1; !bs.empty(); ++batch) {
+    // Parse the next batch, while this one is being processed.
+    auto fc = async(launch::async, [&]() { return readSnapTemporalBatchW(cs, f, batchSize, window); });
+    // Vertex ids are shifted by 1, as label 0 denotes no label.
+    vector<tuple<K, K>> insertions;
+    for (const auto& [u, v, t] : bs) {
+      if (!x.hasVertex(u+1)) insertions.push_back({u+1, u+1});
+      if (!x.hasVertex(v+1)) insertions.push_back({v+1, v+1});
+      if (u!=v) insertions.push_back({u+1, v+1});
+    }
+    // The graph update is reported as the load time of each batch.
+    float tu = measureDuration([&]() { updateGraphU(x, deletions, insertions, V(1)); });
+    auto  xc = csrGraph(x);
+    r.batchSize = bs.size();
+    r.loadTime  = benchmarkStatistics(vector<float> {tu});
+    printf("\n[batch: %04d; edges: %zu; order: %d; size: %zu; update: %.3f ms]\n", batch, bs.size(), xc.order(), xc.size(), tu);
+    runTechnique(xc, r, "labelrankSeqStatic",  1, out, [&]() { return labelrankSeq<4>(xc, o); });
+    runTechnique(xc, r, "labelrankSeqDynamic", 1, out, [&]() { return labelrankSeqDynamic(ls, xc, deletions, insertions, o); });
+    fc.get(); swap(bs, cs);
+  }
 }
 
 
 int main(int argc, char **argv) {
   using K = int;
   using V = float;
+  using T = long;
   char *file = argv[1];
+  // Temporal edge stream (SNAP): <file.txt> [batch size] [time window] [repeat] [output.csv|output.json].
+  size_t L = strlen(file);
+  if (L>=4 && strcmp(file+L-4, ".txt")==0) {
+    size_t batchSize = argc>2? stoul(argv[2]) : 100000;
+    T window   = argc>3? stol(argv[3]) : 0;
+    int repeat = argc>4? stoi(argv[4]) : 1;
+    string out = argc>5? argv[5] : "";
+    printf("Loading temporal graph %s ...\n", file);
+    if (!ifstream(file)) {
+      fprintf(stderr, "error: cannot read graph %s\n", file);
+      return 1;
+    }
+    runTemporalExperiment<K, V>(file, batchSize, window, repeat, out);
+    printf("\n");
+    return 0;
+  }
+  // Static graph (MTX): <file.mtx> [repeat] [output.csv|output.json].
   int repeat = argc>2? stoi(argv[2]) : 5;
-  OutDiGraph<K, None, V> x; V w = 1;
+  string out = argc>3? argv[3] : "";
+  string bin = string(file) + ".bin";
+  string graph = string(file);
+  graph = graph.substr(graph.find_last_of('/')+1);
+  graph = graph.substr(0, graph.find_last_of('.'));
+  vector<float> loadTimes;
+  CsrGraphView<K, V> x;
   printf("Loading graph %s ...\n", file);
-  readMtxW(x, file); println(x);
-  auto y  = symmetricize(x); print(y); printf(" (symmetricize)\n");
-  auto fl = [](auto u) { return true; };
-  selfLoopU(y, w, fl); print(y); printf(" (selfLoopAllVertices)\n");
-  runExperiment(y, repeat);
+  // Use binary snapshot if available (and up to date), otherwise create it.
+  // The snapshot is paged in while loading, so that the first run of a
+  // technique is not charged for it.
+  uint32_t flags = GRAPH_BINARY_SYMMETRIC | GRAPH_BINARY_SELFLOOP;
+  // A missing, invalid, or incompatible snapshot is read (and timed) only once.
+  bool loaded = !isGraphBinaryStale(bin, file);
+  for (int r=0; r<repeat && loaded; ++r) {
+    float t = measureDuration([&]() { loaded = readGraphBinaryW(x, bin, true, flags); });
+    if (loaded) loadTimes.push_back(t);
+  }
+  if (loaded && !loadTimes.empty()) {
+    println(x);
+    printf("[%09.3f ms] readGraphBinaryW\n", benchmarkStatistics(loadTimes).mean);
+    runExperiment(x, graph, loadTimes, repeat, out);
+  }
+  else {
+    CsrGraph<K, V> y;
+    // Parsing is slow on large graphs, so it is only done (and timed) once.
+    bool ok = false;
+    loadTimes.clear();
+    loadTimes.push_back(measureDuration([&]() { ok = readMtxOmpW(y, file, true, true); }));
+    if (!ok) {
+      fprintf(stderr, "error: cannot read graph %s\n", file);
+      return 1;
+    }
+    println(y);
+    printf("[%09.3f ms] readMtxOmpW (symmetricize, selfLoopAllVertices)\n", benchmarkStatistics(loadTimes).mean);
+    writeGraphBinary(bin, y, flags);
+    runExperiment(y, graph, loadTimes, repeat, out);
+  }
   printf("\n");
   return 0;
 }
@@ -4,8 +4,11 @@ from IPython.display import FileLink
 src="labelrank-static-vs-dynamic"
 inp="/kaggle/input/graphs"
 out="{}.txt".format(src)
+csv="{}.csv".format(src)
 !printf "" > "$out"
+!printf "" > "$csv"
 display(FileLink(out))
+display(FileLink(csv))
 !ulimit -s unlimited && echo ""
 
 # Download program
@@ -14,21 +17,21 @@ display(FileLink(out))
 !echo ""
 
 # Run
-!g++ -std=c++17 -O3 main.cxx
-!stdbuf --output=L ./a.out $inp/web-Stanford.mtx      2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/web-BerkStan.mtx      2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/web-Google.mtx        2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/web-NotreDame.mtx     2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/soc-Slashdot0811.mtx  2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/soc-Slashdot0902.mtx  2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/soc-Epinions1.mtx     2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/coAuthorsDBLP.mtx     2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/coAuthorsCiteseer.mtx 2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/soc-LiveJournal1.mtx  2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/coPapersCiteseer.mtx  2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/coPapersDBLP.mtx      2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/indochina-2004.mtx    2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/italy_osm.mtx         2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/great-britain_osm.mtx 2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/germany_osm.mtx       2>&1 | tee -a "$out"
-!stdbuf --output=L ./a.out $inp/asia_osm.mtx          2>&1 | tee -a "$out"
+!g++ -std=c++17 -O3 -march=native -fopenmp main.cxx
+!stdbuf --output=L ./a.out $inp/web-Stanford.mtx 5 "$csv"      2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/web-BerkStan.mtx 5 "$csv"      2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/web-Google.mtx 5 "$csv"        2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/web-NotreDame.mtx 5 "$csv"     2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/soc-Slashdot0811.mtx 5 "$csv"  2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/soc-Slashdot0902.mtx 5 "$csv"  2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/soc-Epinions1.mtx 5 "$csv"     2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/coAuthorsDBLP.mtx 5 "$csv"     2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/coAuthorsCiteseer.mtx 5 "$csv" 2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/soc-LiveJournal1.mtx 5 "$csv"  2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/coPapersCiteseer.mtx 5 "$csv"  2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/coPapersDBLP.mtx 5 "$csv"      2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/indochina-2004.mtx 5 "$csv"    2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/italy_osm.mtx 5 "$csv"         2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/great-britain_osm.mtx 5 "$csv" 2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/germany_osm.mtx 5 "$csv"       2>&1 | tee -a "$out"
+!stdbuf --output=L ./a.out $inp/asia_osm.mtx 5 "$csv"          2>&1 | tee -a "$out"
@@ -4,7 +4,9 @@ const path = require('path');
 
 const RGRAPH = /^Loading graph .*\/(.*?)\.mtx \.\.\./m;
 const RORDER = /^order: (\d+) size: (\d+) (?:\[\w+\] )?\{\}/m;
-const RRESLT = /^\[(\d+) edges; (.+?) gini_coef\.\] (\w+)/m;
+const RTHRDS = /^\[threads: (\d+); repeat: (\d+)\]/m;
+const RBATCH = /^\[batch_size: (\d+); deletions: (\d+); insertions: (\d+)\]/m;
+const RRESLT = /^\[0*([\d\.]+) ms; 0*([\d\.]+) ms init; 0*(\d+) iters\.; 0*(\d+) updated; (-?[\d\.]+) modularity\] (\w+)/m;
 
 
 
@@ -46,18 +48,32 @@ function readLogLine(ln, data, state) {
   if (RGRAPH.test(ln)) {
     var [, graph] = RGRAPH.exec(ln);
     if (!data.has(graph)) data.set(graph, []);
-    state = {graph};
+    state = {graph, batch_size: 0, deletions: 0, insertions: 0};
   }
   else if (RORDER.test(ln)) {
     var [, order, size] = RORDER.exec(ln);
     state.order = parseFloat(order);
     state.size  = parseFloat(size);
   }
+  else if (RTHRDS.test(ln)) {
+    var [, threads, repeat] = RTHRDS.exec(ln);
+    state.threads = parseFloat(threads);
+    state.repeat  = parseFloat(repeat);
+  }
+  else if (RBATCH.test(ln)) {
+    var [, batch_size, deletions, insertions] = RBATCH.exec(ln);
+    state.batch_size = parseFloat(batch_size);
+    state.deletions  = parseFloat(deletions);
+    state.insertions = parseFloat(insertions);
+  }
   else if (RRESLT.test(ln)) {
-    var [, edges, gini_coefficient, technique] = RRESLT.exec(ln);
+    var [, time, init_time, iterations, updated, modularity, technique] = RRESLT.exec(ln);
     data.get(state.graph).push(Object.assign({}, state, {
-      edges:            parseFloat(edges),
-      gini_coefficient: parseFloat(gini_coefficient),
+      time:       parseFloat(time),
+      init_time:  parseFloat(init_time),
+      iterations: parseFloat(iterations),
+      updated:    parseFloat(updated),
+      modularity: parseFloat(modularity),
       technique
     }));
   }
@@ -4,6 +4,8 @@
 #include <algorithm>
 #include <array>
 #include <vector>
+#include <type_traits>
+#include "_main.hxx"
 
 using std::pair;
 using std::array;
@@ -12,6 +14,9 @@ using std::make_pair;
 using std::min;
 using std::pow;
 using std::sort;
+using std::nth_element;
+using std::swap;
+using std::is_same_v;
 
 
 
@@ -24,6 +29,16 @@ template <class K, class V, size_t L>
 using Labelset = array<pair<K, V>, L>;
 
 
+// Packed (structure-of-arrays) labelset, with label ids and probabilities
+// stored separately. This allows label ids to be matched with SIMD
+// instructions (SSE2 for 4 labels, AVX2 for 8 labels, of 32-bit ids).
+template <class K, class V, size_t L>
+struct alignas(32) PackedLabelset {
+  array<K, L> keys;
+  array<V, L> values;
+};
+
+
 
 
 // Labelset for combining multiple labelsets.
@@ -100,6 +115,151 @@ using ALabelset = AccumulatorLabelset<K, V>;
 
 
 
+// Labelset for combining multiple labelsets, using a small open-addressing
+// hash table (linear probing) instead of a dense array over all keys. The
+// table starts small enough to fit in L1 cache, and grows only when it gets
+// half full (it is shrunk back on clear). Key 0 (no label) marks an empty slot.
+template <class K, class V>
+struct HashAccumulatorLabelset {
+  vector<K> hkeys;
+  vector<V> hvalues;
+  vector<size_t> slots;
+  size_t mask;
+  size_t base;
+
+  // Lifetime operations.
+  HashAccumulatorLabelset(size_t capacity=1024) {
+    size_t n = 16;
+    while (n<capacity) n *= 2;
+    hkeys.resize(n);
+    hvalues.resize(n);
+    mask = n-1;
+    base = n;
+  }
+
+  // Read operations.
+  inline size_t size() const {
+    return slots.size();
+  }
+
+  // Access operations.
+  template <class F>
+  inline void forEach(F fn) const {
+    for (size_t i : slots)
+      fn(hkeys[i], hvalues[i]);
+  }
+  template <class F>
+  inline void forEach(F fn) {
+    for (size_t i : slots)
+      fn(hkeys[i], hvalues[i]);
+  }
+  inline K keyAt(size_t i) const {
+    return hkeys[slots[i]];
+  }
+  inline auto getAt(size_t i) const {
+    size_t j = slots[i];
+    return make_pair(hkeys[j], hvalues[j]);
+  }
+  inline void setAt(size_t i, V v) {
+    hvalues[slots[i]] = v;
+  }
+  inline void accumulateAt(size_t i, V v) {
+    hvalues[slots[i]] += v;
+  }
+  inline bool has(K k) const {
+    return k!=K() && hkeys[locate(k)]==k;
+  }
+  inline V get(K k) const {
+    size_t j = locate(k);
+    return k!=K() && hkeys[j]==k? hvalues[j] : V();
+  }
+  inline void set(K k, V v) {
+    hvalues[insert(k)] = v;
+  }
+  inline void accumulate(K k, V v) {
+    hvalues[insert(k)] += v;
+  }
+
+  // Update operations.
+  inline void clear() {
+    // Shrink back after a high-degree vertex, to stay cache resident.
+    if (hkeys.size()>base) {
+      vector<K>(base).swap(hkeys);
+      vector<V>(base).swap(hvalues);
+      mask = base-1;
+    }
+    else for (size_t i : slots) {
+      hkeys[i]   = K();
+      hvalues[i] = V();
+    }
+    slots.clear();
+  }
+  template <class F>
+  inline void reorder(F fn) {
+    sort(slots.begin(), slots.end(), [&](size_t i, size_t j) { return fn(hkeys[i], hkeys[j]); });
+  }
+  // Place n highest values first (in order, ties by lower key), leaving the rest unordered.
+  inline void reorderTop(size_t n) {
+    auto fl = [&](size_t i, size_t j) {
+      return hvalues[i] > hvalues[j] || (hvalues[i]==hvalues[j] && hkeys[i] < hkeys[j]);
+    };
+    if (n>=slots.size()) { sort(slots.begin(), slots.end(), fl); return; }
+    nth_element(slots.begin(), slots.begin()+n, slots.end(), fl);
+    sort(slots.begin(), slots.begin()+n, fl);
+  }
+
+  // Helper operations.
+  protected:
+  inline size_t hash(K k) const {
+    return (size_t(k) * 0x9E3779B97F4A7C15ULL) >> 32;
+  }
+  inline size_t locate(K k) const {
+    size_t i = hash(k) & mask;
+    while (hkeys[i]!=k && hkeys[i]!=K())
+      i = (i+1) & mask;
+    return i;
+  }
+  inline size_t insert(K k) {
+    size_t i = locate(k);
+    if (hkeys[i]==k) return i;
+    if (2*(slots.size()+1) > hkeys.size()) { grow(); i = locate(k); }
+    hkeys[i] = k;
+    slots.push_back(i);
+    return i;
+  }
+  inline void grow() {
+    vector<K> okeys(2*hkeys.size());
+    vector<V> ovalues(2*hvalues.size());
+    swap(hkeys, okeys); swap(hvalues, ovalues);
+    mask = hkeys.size()-1;
+    for (size_t& s : slots) {
+      size_t i = locate(okeys[s]);
+      hkeys[i]   = okeys[s];
+      hvalues[i] = ovalues[s];
+      s = i;
+    }
+  }
+};
+template <class K, class V>
+using HLabelset = HashAccumulatorLabelset<K, V>;
+
+
+
+
+/**
+ * Create an accumulator labelset for a graph.
+ * A dense accumulator spans all keys, while a hash accumulator starts small.
+ * @param S span of graph (number of keys)
+ */
+template <tclass2 A, class K, class V>
+inline auto accumulatorLabelset(size_t S) {
+  if constexpr (is_same_v<A<K, V>, ALabelset<K, V>>) return A<K, V>(S);
+  else return A<K, V>();
+}
+
+
+
+
 /**
  * Get size of accumulator labelset.
  * @param x accumulator labelset
@@ -121,6 +281,55 @@ inline size_t labelsetSize(const Labelset<K, V, N>& x) {
 }
 
 
+/**
+ * Get size of packed labelset.
+ * @param x packed labelset
+ */
+template <class K, class V, size_t N>
+inline size_t labelsetSize(const PackedLabelset<K, V, N>& x) {
+  size_t a = 0;
+  for (K k : x.keys)
+    if (k) ++a;
+  return a;
+}
+
+
+/**
+ * Get maximum number of labels in labelset.
+ * @param x labelset
+ */
+template <class K, class V, size_t N>
+constexpr size_t labelsetCapacity(const Labelset<K, V, N>& x) {
+  return N;
+}
+/**
+ * Get maximum number of labels in packed labelset.
+ * @param x packed labelset
+ */
+template <class K, class V, size_t N>
+constexpr size_t labelsetCapacity(const PackedLabelset<K, V, N>& x) {
+  return N;
+}
+
+
+/**
+ * Get the most probable key of labelset.
+ * @param x labelset
+ */
+template <class K, class V, size_t N>
+inline K labelsetFirstKey(const Labelset<K, V, N>& x) {
+  return x[0].first;
+}
+/**
+ * Get the most probable key of packed labelset.
+ * @param x packed labelset
+ */
+template <class K, class V, size_t N>
+inline K labelsetFirstKey(const PackedLabelset<K, V, N>& x) {
+  return x.keys[0];
+}
+
+
 /**
  * Check if an accumulator labelset has a key.
  * @param x accumulator labelset
@@ -172,8 +381,8 @@ inline V labelsetSum(const Labelset<K, V, N>& x) {
  * @param x labelset to combine
  * @param w combining weight
  */
-template <class K, class V, size_t L>
-inline void labelsetCombineU(ALabelset<K, V>& a, const Labelset<K, V, L>& x, V w) {
+template <class A, class K, class V, size_t L>
+inline void labelsetCombineU(A& a, const Labelset<K, V, L>& x, V w) {
   for (auto [k, v] : x)
     if (k) a.accumulate(k, w*v);
 }
@@ -184,8 +393,8 @@ inline void labelsetCombineU(ALabelset<K, V>& a, const Labelset<K, V, L>& x, V w
  * @param a target labelset
  * @param x accumulator labelset
  */
-template <class K, class V, size_t L>
-inline void labelsetCopyW(Labelset<K, V, L>& a, const ALabelset<K, V>& x) {
+template <class A, class K, class V, size_t L>
+inline void labelsetCopyW(Labelset<K, V, L>& a, const A& x) {
   size_t M = min(L, x.size());
   for (size_t i=0; i<M; ++i)
     a[i] = x.getAt(i);
@@ -265,7 +474,28 @@ inline void labelsetMultiplyPowU(Labelset<K, V, N>& a, V m, V e) {
  */
 template <class K, class V>
 inline void labelsetReorderU(ALabelset<K, V>& a) {
-  a.reorder([&](auto k, auto l) { return a.get(k)>a.get(l); });
+  a.reorder([&](auto k, auto l) {
+    V u = a.get(k), v = a.get(l);
+    return u>v || (u==v && k<l);
+  });
+}
+/**
+ * Reorder accumulator set placing higher probability labels first (all labels are sorted).
+ * @param a accumulator labelset
+ * @param n number of labels needed (unused)
+ */
+template <class K, class V>
+inline void labelsetReorderU(ALabelset<K, V>& a, size_t n) {
+  labelsetReorderU(a);
+}
+/**
+ * Reorder hash accumulator set placing n higher probability labels first (partial selection).
+ * @param a hash accumulator labelset
+ * @param n number of labels needed
+ */
+template <class K, class V>
+inline void labelsetReorderU(HLabelset<K, V>& a, size_t n) {
+  a.reorderTop(n);
 }
 
 
@@ -308,3 +538,220 @@ inline bool labelsetIsSubset(const Labelset<K, V, N>& x, const Labelset<K, V, N>
     if (k && !labelsetHas(y, k)) return false;
   return true;
 }
+
+
+
+
+// PACKED-LABELSET
+// ---------------
+
+/**
+ * Check if a packed labelset has a key.
+ * @param x packed labelset
+ * @param k key to check
+ */
+template <class K, class V, size_t N>
+inline bool labelsetHas(const PackedLabelset<K, V, N>& x, K k) {
+  for (K _k : x.keys)
+    if (_k==k) return true;
+  return false;
+}
+
+
+/**
+ * Get sum of values in packed labelset.
+ * @param x packed labelset
+ */
+template <class K, class V, size_t N>
+inline V labelsetSum(const PackedLabelset<K, V, N>& x) {
+  V a = V();
+  for (V v : x.values)
+    a += v;
+  return a;
+}
+
+
+/**
+ * Combine a packed labelset to an accumulator labelset with given weight.
+ * @param a accumulator labelset
+ * @param x packed labelset to combine
+ * @param w combining weight
+ */
+template <class A, class K, class V, size_t L>
+inline void labelsetCombineU(A& a, const PackedLabelset<K, V, L>& x, V w) {
+  for (size_t i=0; i<L; ++i)
+    if (x.keys[i]) a.accumulate(x.keys[i], w*x.values[i]);
+}
+
+
+/**
+ * Copy to a packed labelset from accumulator labelset.
+ * @param a target packed labelset
+ * @param x accumulator labelset
+ */
+template <class A, class K, class V, size_t L>
+inline void labelsetCopyW(PackedLabelset<K, V, L>& a, const A& x) {
+  size_t M = min(L, x.size());
+  for (size_t i=0; i<M; ++i) {
+    auto [k, v] = x.getAt(i);
+    a.keys[i] = k; a.values[i] = v;
+  }
+  for (size_t i=M; i<L; ++i) {
+    a.keys[i] = K(); a.values[i] = V();
+  }
+}
+
+
+/**
+ * Multiply a value to probabilities in packed labelset (probability scaling).
+ * @param a target packed labelset
+ * @param m value to multiply
+ */
+template <class K, class V, size_t N>
+inline void labelsetMultiplyU(PackedLabelset<K, V, N>& a, V m) {
+  for (V& v : a.values)
+    v *= m;
+}
+
+
+/**
+ * Raise each probability with a given exponent in packed labelset (inflation operator).
+ * @param a target packed labelset
+ * @param e exponent value
+ */
+template <class K, class V, size_t N>
+inline void labelsetPowU(PackedLabelset<K, V, N>& a, V e) {
+  labelsetMultiplyPowU(a, V(1), e);
+}
+
+
+/**
+ * Multiply a value and raise each probability with a given exponent in packed labelset (probability scaling + inflation operator).
+ * Exact pow() is used (not powPs()), so that packed labelsets converge to the same communities as dense ones.
+ * @param a target packed labelset
+ * @param m value to multiply
+ * @param e exponent value
+ */
+template <class K, class V, size_t N>
+inline void labelsetMultiplyPowU(PackedLabelset<K, V, N>& a, V m, V e) {
+  for (V& v : a.values)
+    v = pow(v*m, e);
+}
+
+
+/**
+ * Find which keys of first packed labelset are present in second.
+ * @param x a packed labelset
+ * @param y another packed labelset
+ * @returns bitmask of non-empty keys of x present in y
+ */
+template <class K, class V, size_t N>
+inline unsigned labelsetMatchMask(const PackedLabelset<K, V, N>& x, const PackedLabelset<K, V, N>& y) {
+  static_assert(N<=32, "PackedLabelset supports at most 32 labels");
+#if defined(__SSE2__)
+  if constexpr (sizeof(K)==4 && N==4) {
+    __m128i xk = _mm_loadu_si128((const __m128i*) x.keys.data());
+    __m128i ez = _mm_cmpeq_epi32(xk, _mm_setzero_si128());
+    __m128i eq = _mm_setzero_si128();
+    for (size_t j=0; j<N; ++j)
+      eq = _mm_or_si128(eq, _mm_cmpeq_epi32(xk, _mm_set1_epi32(int(y.keys[j]))));
+    return unsigned(_mm_movemask_ps(_mm_castsi128_ps(_mm_andnot_si128(ez, eq))));
+  }
+#endif
+#if defined(__AVX2__)
+  if constexpr (sizeof(K)==4 && N==8) {
+    __m256i xk = _mm256_loadu_si256((const __m256i*) x.keys.data());
+    __m256i ez = _mm256_cmpeq_epi32(xk, _mm256_setzero_si256());
+    __m256i eq = _mm256_setzero_si256();
+    for (size_t j=0; j<N; ++j)
+      eq = _mm256_or_si256(eq, _mm256_cmpeq_epi32(xk, _mm256_set1_epi32(int(y.keys[j]))));
+    return unsigned(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_andnot_si256(ez, eq))));
+  }
+#endif
+  unsigned a = 0;
+  for (size_t i=0; i<N; ++i)
+    if (x.keys[i] && labelsetHas(y, x.keys[i])) a |= 1u << i;
+  return a;
+}
+
+
+/**
+ * Find which keys of packed labelset are non-empty.
+ * @param x packed labelset
+ * @returns bitmask of non-empty keys
+ */
+template <class K, class V, size_t N>
+inline unsigned labelsetKeyMask(const PackedLabelset<K, V, N>& x) {
+#if defined(__SSE2__)
+  if constexpr (sizeof(K)==4 && N==4) {
+    __m128i xk = _mm_loadu_si128((const __m128i*) x.keys.data());
+    __m128i ez = _mm_cmpeq_epi32(xk, _mm_setzero_si128());
+    return unsigned(~_mm_movemask_ps(_mm_castsi128_ps(ez))) & 0xFu;
+  }
+#endif
+#if defined(__AVX2__)
+  if constexpr (sizeof(K)==4 && N==8) {
+    __m256i xk = _mm256_loadu_si256((const __m256i*) x.keys.data());
+    __m256i ez = _mm256_cmpeq_epi32(xk, _mm256_setzero_si256());
+    return unsigned(~_mm256_movemask_ps(_mm256_castsi256_ps(ez))) & 0xFFu;
+  }
+#endif
+  unsigned a = 0;
+  for (size_t i=0; i<N; ++i)
+    if (x.keys[i]) a |= 1u << i;
+  return a;
+}
+
+
+/**
+ * Count the number of matching keys between packed labelsets.
+ * @param x a packed labelset
+ * @param y another packed labelset
+ */
+template <class K, class V, size_t N>
+inline size_t labelsetMatchCount(const PackedLabelset<K, V, N>& x, const PackedLabelset<K, V, N>& y) {
+  return __builtin_popcount(labelsetMatchMask(x, y));
+}
+
+
+/**
+ * Sum the values of matching keys between packed labelsets.
+ * @param x a packed labelset
+ * @param y another packed labelset
+ */
+template <class K, class V, size_t N>
+inline V labelsetMatchValue(const PackedLabelset<K, V, N>& x, const PackedLabelset<K, V, N>& y) {
+  unsigned m = labelsetMatchMask(x, y);
+  V a = V();
+  for (size_t i=0; i<N; ++i)
+    if (m & (1u << i)) a += x.values[i];
+  return a;
+}
+
+
+/**
+ * Check if first packed labelset is subset of second.
+ * @param x a packed labelset
+ * @param y another packed labelset
+ */
+template <class K, class V, size_t N>
+inline bool labelsetIsSubset(const PackedLabelset<K, V, N>& x, const PackedLabelset<K, V, N>& y) {
+  return labelsetMatchMask(x, y) == labelsetKeyMask(x);
+}
+
+
+
+
+
+// LABELSET-HAS-SAME-KEYS
+// ----------------------
+
+/**
+ * Check if two labelsets have the same (non-empty) keys, in any order.
+ * @param x a labelset
+ * @param y another labelset
+ */
+template <class L>
+inline bool labelsetHasSameKeys(const L& x, const L& y) {
+  return labelsetIsSubset(x, y) && labelsetIsSubset(y, x);
+}
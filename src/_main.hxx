@@ -10,3 +10,5 @@
 #include "_vector.hxx"
 #include "_queue.hxx"
 #include "_bitset.hxx"
+#include "_mmap.hxx"
+#include "_simd.hxx"
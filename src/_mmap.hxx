@@ -0,0 +1,87 @@
+#pragma once
+#include <cstddef>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+
+
+
+// MAPPED-FILE
+// -----------
+// Read-only memory-mapped file (POSIX).
+
+class MappedFile {
+  // Data.
+  protected:
+  int    fd   = -1;
+  void  *addr = nullptr;
+  size_t n    = 0;
+
+
+  // Size operations.
+  public:
+  inline size_t size()  const noexcept { return n; }
+  inline bool   empty() const noexcept { return n == 0; }
+  inline bool   valid() const noexcept { return addr != nullptr; }
+
+
+  // Access operations.
+  public:
+  inline const char* data()  const noexcept { return (const char*) addr; }
+  inline const char* begin() const noexcept { return data(); }
+  inline const char* end()   const noexcept { return data() + n; }
+
+
+  // Update operations.
+  public:
+  inline bool open(const char *pth) {
+    close();
+    struct stat st;
+    if ((fd = ::open(pth, O_RDONLY)) < 0) return false;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) { close(); return false; }
+    n    = st.st_size;
+    addr = mmap(nullptr, n, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (addr == MAP_FAILED) { addr = nullptr; close(); return false; }
+    return true;
+  }
+
+  inline void adviseSequential() noexcept {
+    if (addr) madvise(addr, n, MADV_SEQUENTIAL);
+  }
+
+  // Fault in all pages now, instead of on first access.
+  inline void populate() noexcept {
+    if (!addr) return;
+    madvise(addr, n, MADV_WILLNEED);
+    size_t P = sysconf(_SC_PAGESIZE);
+    volatile char c = 0;
+    for (size_t i=0; i<n; i+=P)
+      c += data()[i];
+  }
+
+  inline void close() noexcept {
+    if (addr) munmap(addr, n);
+    if (fd >= 0) ::close(fd);
+    fd = -1; addr = nullptr; n = 0;
+  }
+
+
+  // Lifetime operations.
+  public:
+  MappedFile(const char *pth) { open(pth); }
+  MappedFile() {}
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+  MappedFile(MappedFile&& x) noexcept :
+  fd(x.fd), addr(x.addr), n(x.n) { x.fd = -1; x.addr = nullptr; x.n = 0; }
+  MappedFile& operator=(MappedFile&& x) noexcept {
+    if (this == &x) return *this;
+    close();
+    fd = x.fd; addr = x.addr; n = x.n;
+    x.fd = -1; x.addr = nullptr; x.n = 0;
+    return *this;
+  }
+  ~MappedFile() { close(); }
+};
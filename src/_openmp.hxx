@@ -58,7 +58,7 @@ inline size_t copyValuesOmp(const vector<T>& x, vector<TA>& a, size_t i, size_t
 
 template <class T, class V>
 void fillValueOmp(T *a, size_t N, const V& v) {
-  if (N<SIZE_MIN_OMPM) { fillValue(a, N, v); return; }
+  if (N<SIZE_MIN_OMPM) { fillValueU(a, N, v); return; }
   #pragma omp parallel for num_threads(32) schedule(auto)
   for (size_t i=0; i<N; ++i)
     a[i] = v;
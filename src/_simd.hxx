@@ -0,0 +1,86 @@
+#pragma once
+#if defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+
+
+
+// EXP-PS, LOG-PS, POW-PS
+// ----------------------
+// Vectorized natural exponent/logarithm of packed floats.
+// Cephes polynomial approximations, with ~1e-6 relative error (powPs).
+// @see http://gruntthepeon.free.fr/ssemath/
+
+#if defined(__SSE2__)
+#define SIMD_MATH_PS(T, TI, F, FI, CAST, CASTI, CMPLE, CMPLT, CMPGT) \
+  inline T logPs(T x) { \
+    const T one = F##set1_ps(1.0f); \
+    T invalid = CMPLE(x, F##setzero_ps()); \
+    x = F##max_ps(x, CAST(FI##set1_epi32(0x00800000))); \
+    TI emm0 = FI##srli_epi32(CASTI(x), 23); \
+    x = F##and_ps(x, CAST(FI##set1_epi32(~0x7f800000))); \
+    x = F##or_ps(x, F##set1_ps(0.5f)); \
+    emm0 = FI##sub_epi32(emm0, FI##set1_epi32(0x7f)); \
+    T e = F##add_ps(F##cvtepi32_ps(emm0), one); \
+    T mask = CMPLT(x, F##set1_ps(0.707106781186547524f)); \
+    T tmp  = F##and_ps(x, mask); \
+    x = F##sub_ps(x, one); \
+    e = F##sub_ps(e, F##and_ps(one, mask)); \
+    x = F##add_ps(x, tmp); \
+    T z = F##mul_ps(x, x); \
+    T y = F##set1_ps(7.0376836292e-2f); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(-1.1514610310e-1f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps( 1.1676998740e-1f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(-1.2420140846e-1f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps( 1.4249322787e-1f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(-1.6668057665e-1f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps( 2.0000714765e-1f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(-2.4999993993e-1f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps( 3.3333331174e-1f)); \
+    y = F##mul_ps(F##mul_ps(y, x), z); \
+    y = F##add_ps(y, F##mul_ps(e, F##set1_ps(-2.12194440e-4f))); \
+    y = F##sub_ps(y, F##mul_ps(z, F##set1_ps(0.5f))); \
+    x = F##add_ps(x, y); \
+    x = F##add_ps(x, F##mul_ps(e, F##set1_ps(0.693359375f))); \
+    return F##or_ps(x, invalid); \
+  } \
+  \
+  inline T expPs(T x) { \
+    const T one = F##set1_ps(1.0f); \
+    x = F##min_ps(x, F##set1_ps( 88.3762626647949f)); \
+    x = F##max_ps(x, F##set1_ps(-88.3762626647949f)); \
+    T fx = F##add_ps(F##mul_ps(x, F##set1_ps(1.44269504088896341f)), F##set1_ps(0.5f)); \
+    T tmp = F##cvtepi32_ps(F##cvttps_epi32(fx)); \
+    T mask = F##and_ps(CMPGT(tmp, fx), one); \
+    fx = F##sub_ps(tmp, mask); \
+    x = F##sub_ps(x, F##mul_ps(fx, F##set1_ps(0.693359375f))); \
+    x = F##sub_ps(x, F##mul_ps(fx, F##set1_ps(-2.12194440e-4f))); \
+    T z = F##mul_ps(x, x); \
+    T y = F##set1_ps(1.9875691500e-4f); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(1.3981999507e-3f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(8.3334519073e-3f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(4.1665795894e-2f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(1.6666665459e-1f)); \
+    y = F##add_ps(F##mul_ps(y, x), F##set1_ps(5.0000001201e-1f)); \
+    y = F##add_ps(F##add_ps(F##mul_ps(y, z), x), one); \
+    TI emm0 = FI##add_epi32(F##cvttps_epi32(fx), FI##set1_epi32(0x7f)); \
+    emm0 = FI##slli_epi32(emm0, 23); \
+    return F##mul_ps(y, CAST(emm0)); \
+  } \
+  \
+  /* Raise positive values to a power (zero stays zero). */ \
+  inline T powPs(T x, T e) { \
+    T nz = CMPGT(x, F##setzero_ps()); \
+    return F##and_ps(expPs(F##mul_ps(e, logPs(x))), nz); \
+  }
+
+SIMD_MATH_PS(__m128, __m128i, _mm_, _mm_, _mm_castsi128_ps, _mm_castps_si128, _mm_cmple_ps, _mm_cmplt_ps, _mm_cmpgt_ps)
+#endif
+
+#if defined(__AVX2__)
+inline __m256 cmpleAvxPs(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+inline __m256 cmpltAvxPs(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+inline __m256 cmpgtAvxPs(__m256 a, __m256 b) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+SIMD_MATH_PS(__m256, __m256i, _mm256_, _mm256_, _mm256_castsi256_ps, _mm256_castps_si256, cmpleAvxPs, cmpltAvxPs, cmpgtAvxPs)
+#endif
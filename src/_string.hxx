@@ -1,7 +1,9 @@
 #pragma once
 #include <string>
+#include <cmath>
 
 using std::string;
+using std::pow;
 
 
 
@@ -21,3 +23,84 @@ size_t countLines(const char* x) {
 size_t countLines(const string& x) {
   return countLines(x.c_str());
 }
+
+
+
+
+// READ-*
+// ------
+// Fast number parsing, for reading graphs.
+
+/**
+ * Skip spaces and tabs (but not newlines).
+ * @param x begin of text
+ * @param xe end of text
+ * @returns pointer to first non-blank character
+ */
+inline const char* skipBlanks(const char *x, const char *xe) {
+  for (; x<xe && (*x==' ' || *x=='\t'); ++x);
+  return x;
+}
+
+
+/**
+ * Skip to the beginning of next line.
+ * @param x begin of text
+ * @param xe end of text
+ * @returns pointer to the first character after newline
+ */
+inline const char* skipLine(const char *x, const char *xe) {
+  for (; x<xe && *x!='\n'; ++x);
+  return x<xe? x+1 : xe;
+}
+
+
+/**
+ * Read an unsigned integer.
+ * @param a read value (output)
+ * @param x begin of text
+ * @param xe end of text
+ * @returns pointer after the integer, or nullptr if no digits
+ */
+template <class T>
+inline const char* readWholeNumberW(T& a, const char *x, const char *xe) {
+  x = skipBlanks(x, xe);
+  if (x>=xe || *x<'0' || *x>'9') return nullptr;
+  T v = T();
+  for (; x<xe && *x>='0' && *x<='9'; ++x)
+    v = v*10 + T(*x-'0');
+  a = v;
+  return x;
+}
+
+
+/**
+ * Read a (signed) floating point number, in decimal or exponent form.
+ * @param a read value (output)
+ * @param x begin of text
+ * @param xe end of text
+ * @returns pointer after the number, or nullptr if no digits
+ */
+template <class T>
+inline const char* readFloatW(T& a, const char *x, const char *xe) {
+  x = skipBlanks(x, xe);
+  bool neg = false, any = false;
+  if (x<xe && (*x=='-' || *x=='+')) neg = *(x++)=='-';
+  double v = 0, f = 1;
+  for (; x<xe && *x>='0' && *x<='9'; ++x, any=true)
+    v = v*10 + (*x-'0');
+  if (x<xe && *x=='.') {
+    for (++x; x<xe && *x>='0' && *x<='9'; ++x, any=true)
+      v += (*x-'0') * (f *= 0.1);
+  }
+  if (!any) return nullptr;
+  if (x<xe && (*x=='e' || *x=='E')) {
+    int e = 0; bool eneg = false; ++x;
+    if (x<xe && (*x=='-' || *x=='+')) eneg = *(x++)=='-';
+    for (; x<xe && *x>='0' && *x<='9'; ++x)
+      e = e*10 + (*x-'0');
+    v *= pow(10.0, eneg? -e : e);
+  }
+  a = T(neg? -v : v);
+  return x;
+}
@@ -1,8 +1,16 @@
 #pragma once
 #include <utility>
 #include <chrono>
+#include <string>
+#include <fstream>
+#include <sys/resource.h>
 
 using std::pair;
+using std::string;
+using std::ifstream;
+using std::ofstream;
+using std::getline;
+using std::stoull;
 using std::chrono::microseconds;
 using std::chrono::high_resolution_clock;
 using std::chrono::duration_cast;
@@ -63,6 +71,41 @@ float measureDurationMarked(F fn, int N=1) {
 
 
 
+// PEAK-MEMORY
+// -----------
+
+/**
+ * Reset the peak resident memory (high-water mark) of this process to its
+ * current resident memory (Linux only, otherwise the peak is cumulative).
+ */
+inline void resetPeakMemory() {
+  ofstream f("/proc/self/clear_refs");
+  if (f) f << "5";
+}
+
+
+/**
+ * Get the peak resident memory (high-water mark) of this process,
+ * since the last resetPeakMemory().
+ * @returns peak resident set size [bytes]
+ */
+inline size_t peakMemoryBytes() {
+  ifstream f("/proc/self/status");
+  for (string ln; getline(f, ln);)
+    if (ln.compare(0, 6, "VmHWM:")==0) return size_t(stoull(ln.substr(6))) * 1024;
+  // Fallback: peak since process start.
+  struct rusage r;
+  if (getrusage(RUSAGE_SELF, &r)!=0) return 0;
+  #ifdef __APPLE__
+  return size_t(r.ru_maxrss);
+  #else
+  return size_t(r.ru_maxrss) * 1024;
+  #endif
+}
+
+
+
+
 // RETRY
 // -----
 
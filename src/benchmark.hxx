@@ -0,0 +1,176 @@
+#pragma once
+#include <cmath>
+#include <string>
+#include <vector>
+#include <ostream>
+#include <fstream>
+#include <algorithm>
+#include "_main.hxx"
+
+using std::string;
+using std::vector;
+using std::ostream;
+using std::ofstream;
+using std::ios;
+using std::min;
+using std::sqrt;
+
+
+
+
+// BENCHMARK-STATISTICS
+// --------------------
+
+struct BenchmarkStatistics {
+  float mean;
+  float min;
+  float stddev;
+};
+
+
+/**
+ * Summarize a set of samples (e.g., timings of each repeat).
+ * @param x samples
+ * @returns mean, minimum, and (population) standard deviation
+ */
+template <class T>
+BenchmarkStatistics benchmarkStatistics(const vector<T>& x) {
+  BenchmarkStatistics a = {};
+  size_t N = x.size();
+  if (N==0) return a;
+  double sum = 0, sqr = 0; a.min = float(x[0]);
+  for (auto v : x) {
+    sum += v;
+    a.min = min(a.min, float(v));
+  }
+  double mean = sum/N;
+  for (auto v : x)
+    sqr += (v - mean) * (v - mean);
+  a.mean   = float(mean);
+  a.stddev = float(sqrt(sqr/N));
+  return a;
+}
+
+
+
+
+// BENCHMARK-RECORD
+// ----------------
+// One row of benchmark results (for one technique, on one graph/batch).
+// All times are in milliseconds.
+
+struct BenchmarkRecord {
+  string graph;
+  string technique;
+  size_t order;
+  size_t size;
+  size_t batchSize;
+  int    threads;
+  int    repeat;
+  BenchmarkStatistics loadTime;
+  BenchmarkStatistics initializationTime;
+  BenchmarkStatistics iterationTime;
+  int    iterations;
+  size_t updated;
+  vector<size_t> updates;
+  vector<float>  updateTimes;
+  size_t peakMemory;
+  double modularity;
+};
+
+
+
+
+// WRITE-BENCHMARK-CSV
+// -------------------
+
+inline void writeBenchmarkCsvHeader(ostream& a) {
+  a << "graph,technique,order,size,batch_size,threads,repeat,"
+    << "load_mean,load_min,load_stddev,"
+    << "init_mean,init_min,init_stddev,"
+    << "iter_mean,iter_min,iter_stddev,"
+    << "iterations,updated,updates,update_times,peak_memory,modularity\n";
+}
+
+inline void writeBenchmarkCsvStatistics(ostream& a, const BenchmarkStatistics& x) {
+  a << x.mean << ',' << x.min << ',' << x.stddev << ',';
+}
+
+/**
+ * Write a benchmark record as a CSV row (per-iteration values are separated by ';').
+ * @param a output stream
+ * @param x benchmark record
+ */
+inline void writeBenchmarkCsv(ostream& a, const BenchmarkRecord& x) {
+  a << '"' << x.graph << "\",\"" << x.technique << "\",";
+  a << x.order << ',' << x.size << ',' << x.batchSize << ',' << x.threads << ',' << x.repeat << ',';
+  writeBenchmarkCsvStatistics(a, x.loadTime);
+  writeBenchmarkCsvStatistics(a, x.initializationTime);
+  writeBenchmarkCsvStatistics(a, x.iterationTime);
+  a << x.iterations << ',' << x.updated << ",\"";
+  for (size_t i=0; i<x.updates.size(); ++i)
+    a << (i? ";" : "") << x.updates[i];
+  a << "\",\"";
+  for (size_t i=0; i<x.updateTimes.size(); ++i)
+    a << (i? ";" : "") << x.updateTimes[i];
+  a << "\"," << x.peakMemory << ',' << x.modularity << '\n';
+}
+
+
+
+
+// WRITE-BENCHMARK-JSON
+// --------------------
+
+inline void writeBenchmarkJsonStatistics(ostream& a, const char *k, const BenchmarkStatistics& x) {
+  a << "\"" << k << "\": {\"mean\": " << x.mean << ", \"min\": " << x.min << ", \"stddev\": " << x.stddev << "}, ";
+}
+
+/**
+ * Write a benchmark record as a single-line JSON object (JSON Lines).
+ * @param a output stream
+ * @param x benchmark record
+ */
+inline void writeBenchmarkJson(ostream& a, const BenchmarkRecord& x) {
+  a << "{\"graph\": \"" << x.graph << "\", \"technique\": \"" << x.technique << "\", ";
+  a << "\"order\": " << x.order << ", \"size\": " << x.size << ", \"batch_size\": " << x.batchSize << ", ";
+  a << "\"threads\": " << x.threads << ", \"repeat\": " << x.repeat << ", ";
+  writeBenchmarkJsonStatistics(a, "load",       x.loadTime);
+  writeBenchmarkJsonStatistics(a, "init",       x.initializationTime);
+  writeBenchmarkJsonStatistics(a, "iter",       x.iterationTime);
+  a << "\"iterations\": " << x.iterations << ", \"updated\": " << x.updated << ", \"updates\": [";
+  for (size_t i=0; i<x.updates.size(); ++i)
+    a << (i? ", " : "") << x.updates[i];
+  a << "], \"update_times\": [";
+  for (size_t i=0; i<x.updateTimes.size(); ++i)
+    a << (i? ", " : "") << x.updateTimes[i];
+  a << "], \"peak_memory\": " << x.peakMemory << ", \"modularity\": " << x.modularity << "}\n";
+}
+
+
+
+
+// WRITE-BENCHMARK-RECORD
+// ----------------------
+
+/**
+ * Append a benchmark record to a file, as CSV or JSON Lines (.json, .jsonl).
+ * A CSV header is written if the file is new (or empty).
+ * @param pth path to file
+ * @param x benchmark record
+ * @returns true if written successfully
+ */
+inline bool writeBenchmarkRecord(const string& pth, const BenchmarkRecord& x) {
+  auto fext = [&](const char *e) {
+    string s(e);
+    return pth.size()>=s.size() && pth.compare(pth.size()-s.size(), s.size(), s)==0;
+  };
+  ofstream f(pth, ios::app);
+  if (!f) return false;
+  if (fext(".json") || fext(".jsonl")) writeBenchmarkJson(f, x);
+  else {
+    if (f.tellp()==0) writeBenchmarkCsvHeader(f);
+    writeBenchmarkCsv(f, x);
+  }
+  return bool(f);
+}
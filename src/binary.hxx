@@ -0,0 +1,207 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sys/stat.h>
+#include "_main.hxx"
+#include "csr.hxx"
+
+using std::string;
+using std::vector;
+using std::ofstream;
+using std::ios;
+using std::memcmp;
+using std::memcpy;
+
+
+
+
+// GRAPH-BINARY
+// ------------
+// Binary snapshot of a graph in CSR format, which can be memory-mapped and
+// used without copying. All values are little-endian, and each section
+// begins at an 8-byte boundary:
+// - header
+// - vertex exists flags (span x 1 byte)
+// - offsets (span+1 x offsetBytes)
+// - targets (size x keyBytes)
+// - weights (size x edgeBytes)
+
+#define GRAPH_BINARY_MAGIC     "LRGRAPH"
+#define GRAPH_BINARY_VERSION   1
+#define GRAPH_BINARY_DIRECTED  0x1
+#define GRAPH_BINARY_SYMMETRIC 0x2
+#define GRAPH_BINARY_SELFLOOP  0x4
+
+struct GraphBinaryHeader {
+  char     magic[8];
+  uint32_t version;
+  uint32_t flags;
+  uint64_t span;
+  uint64_t order;
+  uint64_t size;
+  uint32_t keyBytes;
+  uint32_t edgeBytes;
+  uint32_t offsetBytes;
+  uint32_t reserved;
+};
+static_assert(sizeof(GraphBinaryHeader)==56, "GraphBinaryHeader must be packed");
+
+
+inline bool isLittleEndian() {
+  uint16_t x = 1;
+  return *((uint8_t*) &x) == 1;
+}
+
+inline size_t alignGraphBinary(size_t n) {
+  return (n + 7) & ~size_t(7);
+}
+
+
+/**
+ * Check if a binary snapshot is older than the file it was created from.
+ * @param pth path to snapshot
+ * @param src path to source file (e.g., MTX)
+ * @returns true if source was modified after snapshot (or either is missing)
+ */
+inline bool isGraphBinaryStale(const char *pth, const char *src) {
+  struct stat sp, ss;
+  if (stat(pth, &sp)!=0 || stat(src, &ss)!=0) return true;
+  #ifdef __linux__
+  if (ss.st_mtim.tv_sec!=sp.st_mtim.tv_sec) return ss.st_mtim.tv_sec > sp.st_mtim.tv_sec;
+  return ss.st_mtim.tv_nsec > sp.st_mtim.tv_nsec;
+  #else
+  return ss.st_mtime >= sp.st_mtime;
+  #endif
+}
+inline bool isGraphBinaryStale(const string& pth, const string& src) {
+  return isGraphBinaryStale(pth.c_str(), src.c_str());
+}
+
+
+
+
+// WRITE-GRAPH-BINARY
+// ------------------
+
+/**
+ * Write a graph as a binary snapshot.
+ * @param pth path to file
+ * @param x original graph
+ * @param flags additional properties of graph (GRAPH_BINARY_SYMMETRIC, GRAPH_BINARY_SELFLOOP)
+ * @returns true if written successfully
+ */
+template <class O=size_t, class G>
+bool writeGraphBinary(const char *pth, const G& x, uint32_t flags=0) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  if (!isLittleEndian()) return false;
+  ofstream f(pth, ios::binary);
+  if (!f) return false;
+  auto fpad = [&](size_t n) {
+    const char zeros[8] = {};
+    f.write(zeros, alignGraphBinary(n) - n);
+  };
+  size_t S = x.span();
+  GraphBinaryHeader h = {};
+  memcpy(h.magic, GRAPH_BINARY_MAGIC, sizeof(GRAPH_BINARY_MAGIC));
+  h.version = GRAPH_BINARY_VERSION;
+  h.flags   = flags | (x.directed()? GRAPH_BINARY_DIRECTED : 0);
+  h.span    = S;
+  h.order   = x.order();
+  h.size    = x.size();
+  h.keyBytes    = sizeof(K);
+  h.edgeBytes   = sizeof(E);
+  h.offsetBytes = sizeof(O);
+  f.write((const char*) &h, sizeof(h));
+  vector<uint8_t> vexists(S);
+  x.forEachVertexKey([&](auto u) { vexists[u] = 1; });
+  f.write((const char*) vexists.data(), S); fpad(S);
+  O i = O();
+  f.write((const char*) &i, sizeof(O));
+  for (K u=0; u<K(S); ++u) {
+    i += x.degree(u);
+    f.write((const char*) &i, sizeof(O));
+  }
+  fpad((S+1) * sizeof(O));
+  for (K u=0; u<K(S); ++u)
+    x.forEachEdgeKey(u, [&](auto v) { K k = v; f.write((const char*) &k, sizeof(K)); });
+  fpad(h.size * sizeof(K));
+  for (K u=0; u<K(S); ++u)
+    x.forEachEdgeValue(u, [&](auto w) { E e = w; f.write((const char*) &e, sizeof(E)); });
+  fpad(h.size * sizeof(E));
+  return bool(f);
+}
+template <class O=size_t, class G>
+inline bool writeGraphBinary(const string& pth, const G& x, uint32_t flags=0) {
+  return writeGraphBinary<O>(pth.c_str(), x, flags);
+}
+
+
+
+
+// READ-GRAPH-BINARY
+// -----------------
+
+/**
+ * Read (memory-map) a binary snapshot of a graph, without copying.
+ * @param a output graph view (owns the mapping)
+ * @param pth path to file
+ * @param populate fault in the whole file now (instead of on first access)?
+ * @param flags properties the graph must have (GRAPH_BINARY_SYMMETRIC, GRAPH_BINARY_SELFLOOP)
+ * @returns true if file was a valid, consistent snapshot of matching types and properties
+ */
+template <class K, class E, class O>
+bool readGraphBinaryW(CsrGraphView<K, E, O>& a, const char *pth, bool populate=false, uint32_t flags=0) {
+  if (!isLittleEndian()) return false;
+  MappedFile f(pth);
+  if (!f.valid() || f.size() < sizeof(GraphBinaryHeader)) return false;
+  GraphBinaryHeader h;
+  memcpy(&h, f.data(), sizeof(h));
+  if (memcmp(h.magic, GRAPH_BINARY_MAGIC, sizeof(GRAPH_BINARY_MAGIC))!=0) return false;
+  if (h.version!=GRAPH_BINARY_VERSION) return false;
+  if (h.keyBytes!=sizeof(K) || h.edgeBytes!=sizeof(E) || h.offsetBytes!=sizeof(O)) return false;
+  if ((h.flags & flags)!=flags) return false;
+  size_t S = h.span, M = h.size;
+  size_t pv = alignGraphBinary(sizeof(h));
+  size_t po = pv + alignGraphBinary(S);
+  size_t pt = po + alignGraphBinary((S+1) * sizeof(O));
+  size_t pw = pt + alignGraphBinary(M * sizeof(K));
+  size_t pe = pw + alignGraphBinary(M * sizeof(E));
+  if (f.size() < pe) return false;
+  if (populate) f.populate();
+  const char *x = f.data();
+  auto vexists = (const uint8_t*) (x + pv);
+  auto offsets = (const O*) (x + po);
+  auto targets = (const K*) (x + pt);
+  auto weights = (const E*) (x + pw);
+  // Check consistency, so that a corrupt snapshot cannot cause out-of-bounds
+  // access, and that edges are sorted (for hasEdge).
+  if (offsets[0]!=0 || offsets[S]!=M) return false;
+  size_t N = 0;
+  for (size_t u=0; u<S; ++u) {
+    if (offsets[u] > offsets[u+1]) return false;
+    if (vexists[u]) ++N;
+  }
+  if (N!=h.order) return false;
+  for (size_t u=0; u<S; ++u) {
+    for (O i=offsets[u]; i<offsets[u+1]; ++i) {
+      if (size_t(targets[i]) >= S) return false;
+      if (i>offsets[u] && targets[i-1] > targets[i]) return false;
+    }
+  }
+  a = CsrGraphView<K, E, O>(move(f), S, h.order, M, vexists, offsets, targets, weights);
+  return true;
+}
+template <class K, class E, class O>
+inline bool readGraphBinaryW(CsrGraphView<K, E, O>& a, const string& pth, bool populate=false, uint32_t flags=0) {
+  return readGraphBinaryW(a, pth.c_str(), populate, flags);
+}
+
+template <class K=int, class E=NONE, class O=size_t>
+inline auto readGraphBinary(const char *pth) {
+  CsrGraphView<K, E, O> a; readGraphBinaryW(a, pth);
+  return a;
+}
@@ -1,10 +1,21 @@
 #pragma once
+#include <cstdint>
 #include <vector>
+#include <utility>
 #include <algorithm>
+#include <ostream>
 #include "_main.hxx"
+#include "Graph.hxx"
+#include "edges.hxx"
 
 using std::vector;
 using std::transform;
+using std::lower_bound;
+using std::is_sorted;
+using std::sort;
+using std::pair;
+using std::move;
+using std::ostream;
 
 
 
@@ -65,3 +76,259 @@ inline auto destinationIndices(const G& x) {
   using K = typename G::key_type;
   return destinationIndicesAs(x, K());
 }
+
+
+
+
+// CSR-GRAPH
+// ---------
+// Immutable directed graph in compressed sparse row (CSR) format.
+// Vertex keys are retained from the source graph, and edges of each vertex
+// are stored contiguously in targets (and weights), sorted by target (which
+// hasEdge() and edgeValue() rely on).
+
+template <class K=int, class E=NONE, class O=size_t>
+class CsrGraph {
+  // Data.
+  protected:
+  size_t N = 0;
+  vector<bool> vexists;
+  vector<O> offsets;
+  vector<K> targets;
+  vector<E> weights;
+
+  // Types.
+  public:
+  GRAPH_TYPES(K, NONE, E)
+
+
+  // Property operations.
+  public:
+  GRAPH_SIZES(K, NONE, E, N, targets.size(), vexists)
+  GRAPH_DIRECTEDNESS(K, NONE, E, true)
+
+
+  // Scan operations.
+  public:
+  template <class F>
+  inline void forEachVertexKey(F fn) const noexcept {
+    for (K u = K(); u < span(); ++u)
+      if (vexists[u]) fn(u);
+  }
+  template <class F>
+  inline void forEachVertex(F fn) const noexcept {
+    for (K u = K(); u < span(); ++u)
+      if (vexists[u]) fn(u, NONE());
+  }
+  template <class F>
+  inline void forEachEdgeKey(const K& u, F fn) const noexcept {
+    if (u >= span()) return;
+    for (O i = offsets[u], I = offsets[u+1]; i < I; ++i)
+      fn(targets[i]);
+  }
+  template <class F>
+  inline void forEachEdgeValue(const K& u, F fn) const noexcept {
+    if (u >= span()) return;
+    for (O i = offsets[u], I = offsets[u+1]; i < I; ++i)
+      fn(weights[i]);
+  }
+  template <class F>
+  inline void forEachEdge(const K& u, F fn) const noexcept {
+    if (u >= span()) return;
+    for (O i = offsets[u], I = offsets[u+1]; i < I; ++i)
+      fn(targets[i], weights[i]);
+  }
+
+
+  // Access operations.
+  public:
+  inline bool hasVertex(const K& u) const noexcept {
+    return u < span() && vexists[u];
+  }
+  inline bool hasEdge(const K& u, const K& v) const noexcept {
+    if (u >= span()) return false;
+    auto ib = targets.begin() + offsets[u];
+    auto ie = targets.begin() + offsets[u+1];
+    auto it = lower_bound(ib, ie, v);
+    return it != ie && *it == v;
+  }
+  inline K degree(const K& u) const noexcept {
+    return u < span()? K(offsets[u+1] - offsets[u]) : K();
+  }
+  inline E edgeValue(const K& u, const K& v) const noexcept {
+    if (u >= span()) return E();
+    auto ib = targets.begin() + offsets[u];
+    auto ie = targets.begin() + offsets[u+1];
+    auto it = lower_bound(ib, ie, v);
+    return it != ie && *it == v? weights[it - targets.begin()] : E();
+  }
+  inline const vector<O>& sourceOffsets()      const noexcept { return offsets; }
+  inline const vector<K>& destinationIndices() const noexcept { return targets; }
+  inline const vector<E>& edgeValues()         const noexcept { return weights; }
+
+
+  // Helper operations.
+  protected:
+  // Sort edges of each vertex by target, if source graph was not sorted.
+  inline void sortEdges() {
+    vector<pair<K, E>> es;
+    for (size_t u=0; u+1<offsets.size(); ++u) {
+      auto ib = targets.begin() + offsets[u];
+      auto ie = targets.begin() + offsets[u+1];
+      if (is_sorted(ib, ie)) continue;
+      es.clear();
+      for (O i=offsets[u]; i<offsets[u+1]; ++i)
+        es.push_back({targets[i], weights[i]});
+      sort(es.begin(), es.end(), [](const auto& p, const auto& q) { return p.first < q.first; });
+      for (O i=offsets[u], j=0; i<offsets[u+1]; ++i, ++j) {
+        targets[i] = es[j].first;
+        weights[i] = es[j].second;
+      }
+    }
+  }
+
+
+  // Lifetime operations.
+  public:
+  template <class G>
+  CsrGraph(const G& x) :
+  N(x.order()), vexists(x.span()) {
+    auto ks = rangeIterable(x.span());
+    auto fk = [&](auto u, auto v, auto w) { return K(v); };
+    auto fw = [&](auto u, auto v, auto w) { return E(w); };
+    x.forEachVertexKey([&](auto u) { vexists[u] = true; });
+    offsets = sourceOffsetsAs(x, ks, O());
+    targets = edgeData(x, ks, fk);
+    weights = edgeData(x, ks, fw);
+    sortEdges();
+  }
+  // Edges of each vertex must already be sorted by target.
+  CsrGraph(vector<bool>&& vexists, vector<O>&& offsets, vector<K>&& targets, vector<E>&& weights) :
+  vexists(move(vexists)), offsets(move(offsets)), targets(move(targets)), weights(move(weights)) {
+    for (bool e : this->vexists)
+      if (e) ++N;
+  }
+  CsrGraph() {}
+};
+
+
+/**
+ * Convert a graph to compressed sparse row (CSR) format.
+ * @param x original graph
+ * @returns csr graph
+ */
+template <class G>
+inline auto csrGraph(const G& x) {
+  using K = typename G::key_type;
+  using E = typename G::edge_value_type;
+  return CsrGraph<K, E>(x);
+}
+
+
+
+
+
+// CSR-GRAPH-VIEW
+// --------------
+// Immutable directed graph in CSR format, viewing externally owned arrays
+// (such as a memory-mapped file). The backing file, if any, is owned by
+// the view and unmapped along with it. Edges of each vertex must be sorted
+// by target, as in CsrGraph.
+
+template <class K=int, class E=NONE, class O=size_t>
+class CsrGraphView {
+  // Data.
+  protected:
+  MappedFile file;
+  size_t S = 0, N = 0, M = 0;
+  const uint8_t *vexists = nullptr;
+  const O *offsets = nullptr;
+  const K *targets = nullptr;
+  const E *weights = nullptr;
+
+  // Types.
+  public:
+  GRAPH_TYPES(K, NONE, E)
+
+
+  // Property operations.
+  public:
+  inline K span()  const noexcept { return K(S); }
+  inline K order() const noexcept { return K(N); }
+  inline size_t size() const noexcept { return M; }
+  GRAPH_EMPTY(K, NONE, E)
+  GRAPH_DIRECTEDNESS(K, NONE, E, true)
+
+
+  // Scan operations.
+  public:
+  template <class F>
+  inline void forEachVertexKey(F fn) const noexcept {
+    for (K u = K(); u < span(); ++u)
+      if (vexists[u]) fn(u);
+  }
+  template <class F>
+  inline void forEachVertex(F fn) const noexcept {
+    for (K u = K(); u < span(); ++u)
+      if (vexists[u]) fn(u, NONE());
+  }
+  template <class F>
+  inline void forEachEdgeKey(const K& u, F fn) const noexcept {
+    if (u >= span()) return;
+    for (O i = offsets[u], I = offsets[u+1]; i < I; ++i)
+      fn(targets[i]);
+  }
+  template <class F>
+  inline void forEachEdgeValue(const K& u, F fn) const noexcept {
+    if (u >= span()) return;
+    for (O i = offsets[u], I = offsets[u+1]; i < I; ++i)
+      fn(weights[i]);
+  }
+  template <class F>
+  inline void forEachEdge(const K& u, F fn) const noexcept {
+    if (u >= span()) return;
+    for (O i = offsets[u], I = offsets[u+1]; i < I; ++i)
+      fn(targets[i], weights[i]);
+  }
+
+
+  // Access operations.
+  public:
+  inline bool hasVertex(const K& u) const noexcept {
+    return u < span() && vexists[u];
+  }
+  inline bool hasEdge(const K& u, const K& v) const noexcept {
+    if (u >= span()) return false;
+    auto ib = targets + offsets[u];
+    auto ie = targets + offsets[u+1];
+    auto it = lower_bound(ib, ie, v);
+    return it != ie && *it == v;
+  }
+  inline K degree(const K& u) const noexcept {
+    return u < span()? K(offsets[u+1] - offsets[u]) : K();
+  }
+  inline E edgeValue(const K& u, const K& v) const noexcept {
+    if (u >= span()) return E();
+    auto ib = targets + offsets[u];
+    auto ie = targets + offsets[u+1];
+    auto it = lower_bound(ib, ie, v);
+    return it != ie && *it == v? weights[it - targets] : E();
+  }
+
+
+  // Lifetime operations.
+  public:
+  CsrGraphView(MappedFile&& file, size_t S, size_t N, size_t M, const uint8_t *vexists, const O *offsets, const K *targets, const E *weights) :
+  file(move(file)), S(S), N(N), M(M), vexists(vexists), offsets(offsets), targets(targets), weights(weights) {}
+  CsrGraphView() {}
+};
+
+
+template <class K, class E, class O>
+inline void write(ostream& a, const CsrGraph<K, E, O>& x, bool det=false) { writeGraph(a, x, det); }
+template <class K, class E, class O>
+inline ostream& operator<<(ostream& a, const CsrGraph<K, E, O>& x) { write(a, x); return a; }
+template <class K, class E, class O>
+inline void write(ostream& a, const CsrGraphView<K, E, O>& x, bool det=false) { writeGraph(a, x, det); }
+template <class K, class E, class O>
+inline ostream& operator<<(ostream& a, const CsrGraphView<K, E, O>& x) { write(a, x); return a; }
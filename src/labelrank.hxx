@@ -1,4 +1,12 @@
 #pragma once
+#include <utility>
+#include <algorithm>
+#include <vector>
+#include "_main.hxx"
+
+using std::vector;
+using std::move;
+using std::max;
 
 
 
@@ -11,9 +19,10 @@ struct LabelrankOptions {
   int   maxIterations;
   float inflation;
   float conditionalUpdate;
+  bool  frontier;
 
-  LabelrankOptions(int repeat=1, int maxIterations=500, float inflation=1.2f, float conditionalUpdate=0.3f) :
-  repeat(repeat), maxIterations(maxIterations), inflation(inflation), conditionalUpdate(conditionalUpdate) {}
+  LabelrankOptions(int repeat=1, int maxIterations=500, float inflation=1.2f, float conditionalUpdate=0.3f, bool frontier=false) :
+  repeat(repeat), maxIterations(maxIterations), inflation(inflation), conditionalUpdate(conditionalUpdate), frontier(frontier) {}
 };
 
 
@@ -25,12 +34,34 @@ struct LabelrankOptions {
 template <class K>
 struct LabelrankResult {
   vector<K> membership;
-  int   iterations;
-  float time;
+  int    iterations;
+  float  time;
+  float  initializationTime;
+  size_t updated;
+  vector<size_t> updates;
+  vector<float>  updateTimes;
+  vector<float>  initializationTimes;
+  vector<float>  iterationTimes;
+
+  LabelrankResult(vector<K>&& membership, int iterations=0, float time=0, size_t updated=0) :
+  membership(membership), iterations(iterations), time(time), initializationTime(0), updated(updated) {}
 
-  LabelrankResult(vector<K>&& membership, int iterations=0, float time=0) :
-  membership(membership), iterations(iterations), time(time) {}
+  LabelrankResult(vector<K>& membership, int iterations=0, float time=0, size_t updated=0) :
+  membership(move(membership)), iterations(iterations), time(time), initializationTime(0), updated(updated) {}
 
-  LabelrankResult(vector<K>& membership, int iterations=0, float time=0) :
-  membership(move(membership)), iterations(iterations), time(time) {}
+  /**
+   * Result of a (repeated) run, with times averaged over all repeats.
+   * @param membership community membership of each vertex
+   * @param updates number of vertices updated in each iteration (of last repeat)
+   * @param updateTimes time taken by each iteration (of last repeat) [ms]
+   * @param initializationTimes initialization time of each repeat [ms]
+   * @param iterationTimes time taken to converge in each repeat [ms]
+   */
+  LabelrankResult(vector<K>&& membership, vector<size_t>&& updates, vector<float>&& updateTimes, vector<float>&& initializationTimes, vector<float>&& iterationTimes) :
+  membership(move(membership)), iterations(int(updates.size())), updated(sumValues(updates, size_t())),
+  updates(move(updates)), updateTimes(move(updateTimes)), initializationTimes(move(initializationTimes)), iterationTimes(move(iterationTimes)) {
+    size_t R = max(this->iterationTimes.size(), size_t(1));
+    initializationTime = sumValues(this->initializationTimes, 0.0f) / R;
+    time = initializationTime + sumValues(this->iterationTimes, 0.0f) / R;
+  }
 };
@@ -0,0 +1,126 @@
+#pragma once
+#include <utility>
+#include <memory>
+#include <vector>
+#include <omp.h>
+#include "_main.hxx"
+#include "Labelset.hxx"
+#include "labelrank.hxx"
+#include "labelrankSeq.hxx"
+
+using std::vector;
+using std::unique_ptr;
+using std::make_unique;
+using std::swap;
+
+
+
+
+/**
+ * Get the accumulator labelset of the current thread, creating it on first use.
+ * This avoids depending upon the size of any particular team (OMP_DYNAMIC, thread limit).
+ * @param las per-thread accumulator labelsets (updated)
+ * @param S span of graph (number of keys)
+ * @returns accumulator labelset of current thread
+ */
+template <tclass2 A, class K, class V>
+inline A<K, V>& labelrankOmpAccumulator(vector<unique_ptr<A<K, V>>>& las, size_t S) {
+  int t = omp_get_thread_num();
+  if (!las[t]) las[t] = make_unique<A<K, V>>(accumulatorLabelset<A, K, V>(S));
+  return *las[t];
+}
+
+
+/**
+ * Iterate labelsets until convergence, only updating unstable affected vertices.
+ * @param us number of vertices updated in each iteration (output)
+ * @param ts time taken by each iteration [ms] (output)
+ * @param ls current labelsets (updated)
+ * @param ms scratch labelsets
+ * @param las per-thread accumulator labelsets (scratch)
+ * @param x original graph
+ * @param o labelrank options
+ * @param fa is vertex affected (u)?
+ */
+template <tclass2 A, class G, class K, class V, class L, class FA>
+void labelrankOmpLoopU(vector<size_t>& us, vector<float>& ts, vector<L>& ls, vector<L>& ms, vector<unique_ptr<A<K, V>>>& las, const G& x, const LabelrankOptions& o, FA fa) {
+  K S = x.span();
+  us.clear(); ts.clear();
+  size_t updatedPrev = 0;
+  while (int(us.size())<o.maxIterations) {
+    auto t0 = timeNow();
+    size_t updated = 0;
+    #pragma omp parallel for schedule(dynamic, 2048) reduction(+:updated)
+    for (K u=0; u<S; ++u) {
+      if (!x.hasVertex(u)) continue;
+      if (!fa(u) || labelrankIsVertexStable(ls, x, u, o.conditionalUpdate)) ms[u] = ls[u];
+      else { labelrankUpdateVertexW(labelrankOmpAccumulator(las, S), ms, ls, x, u, V(o.inflation)); updated++; }
+    }
+    swap(ls, ms);
+    us.push_back(updated);
+    ts.push_back(durationMilliseconds(t0, timeNow()));
+    if (!updated || updated==updatedPrev) break;
+    updatedPrev = updated;
+  }
+}
+
+
+
+
+// LABELRANK-OMP
+// -------------
+
+/**
+ * Find communities in a graph using LabelRank, starting from scratch (in parallel).
+ * @param ls labelsets (output, can be used for a later dynamic run)
+ * @param x original graph
+ * @param o labelrank options
+ * @returns membership of each vertex, iterations performed, and time taken (averaged over repeats)
+ */
+template <tclass2 A=ALabelset, class G, class L>
+auto labelrankOmpW(vector<L>& ls, const G& x, const LabelrankOptions& o={}) {
+  using K = typename G::key_type;
+  using V = typename G::edge_value_type;
+  K S = x.span();
+  int T = omp_get_max_threads();
+  vector<unique_ptr<A<K, V>>> las(T);
+  // Allocate each accumulator on its own thread, so that it is placed on
+  // that thread's NUMA node, and does not share cache lines with another.
+  #pragma omp parallel
+  labelrankOmpAccumulator(las, S);
+  vector<L> ms(S);
+  vector<size_t> us;
+  vector<float> ts, tis, tls;
+  auto fa = [](auto u) { return true; };
+  for (int r=0; r<o.repeat; ++r) {
+    ls.resize(S);
+    fillValueOmp(ls, L());
+    auto t0 = timeNow();
+    #pragma omp parallel for schedule(dynamic, 2048)
+    for (K u=0; u<S; ++u) {
+      if (!x.hasVertex(u)) continue;
+      labelrankInitializeVertexW(labelrankOmpAccumulator(las, S), ls, x, u, V(o.inflation));
+    }
+    auto t1 = timeNow();
+    labelrankOmpLoopU(us, ts, ls, ms, las, x, o, fa);
+    auto t2 = timeNow();
+    tis.push_back(durationMilliseconds(t0, t1));
+    tls.push_back(durationMilliseconds(t1, t2));
+  }
+  return LabelrankResult<K>(labelrankMembership(x, ls), move(us), move(ts), move(tis), move(tls));
+}
+
+
+/**
+ * Find communities in a graph using LabelRank, starting from scratch (in parallel).
+ * @param x original graph
+ * @param o labelrank options
+ * @returns membership of each vertex, iterations performed, and time taken (averaged over repeats)
+ */
+template <size_t N, tclass2 A=ALabelset, class G>
+auto labelrankOmp(const G& x, const LabelrankOptions& o={}) {
+  using K = typename G::key_type;
+  using V = typename G::edge_value_type;
+  vector<Labelset<K, V, N>> ls;
+  return labelrankOmpW<A>(ls, x, o);
+}
@@ -2,12 +2,16 @@
 #include <utility>
 #include <cmath>
 #include <array>
+#include <tuple>
+#include <vector>
 #include "_main.hxx"
 #include "Labelset.hxx"
 #include "labelrank.hxx"
 
 using std::pair;
 using std::array;
+using std::tuple;
+using std::vector;
 using std::pow;
 
 
@@ -21,14 +25,14 @@ using std::pow;
  * @param u given vertex
  * @param e exponent value
  */
-template <class G, class K, class V, size_t N>
-void labelrankInitializeVertexW(ALabelset<K, V>& a, vector<Labelset<K, V, N>>& as, const G& x, K u, V e) {
+template <class G, class A, class L, class K, class V>
+void labelrankInitializeVertexW(A& a, vector<L>& as, const G& x, K u, V e) {
   V sumw = V(); a.clear();
   x.forEachEdge(u, [&](auto v, auto w) {
     a.set(v, w);
     sumw += w;
   });
-  labelsetReorderU(a);
+  labelsetReorderU(a, labelsetCapacity(as[u]));
   labelsetCopyW(as[u], a);
   labelsetMultiplyPowU(as[u], 1/sumw, e);
 }
@@ -43,14 +47,14 @@ void labelrankInitializeVertexW(ALabelset<K, V>& a, vector<Labelset<K, V, N>>& a
  * @param u given vertex
  * @param e exponent value
  */
-template <class G, class K, class V, size_t N>
-void labelrankUpdateVertexW(ALabelset<K, V>& a, vector<Labelset<K, V, N>>& as, const vector<Labelset<K, V, N>>& ls, const G& x, K u, V e) {
+template <class G, class A, class L, class K, class V>
+void labelrankUpdateVertexW(A& a, vector<L>& as, const vector<L>& ls, const G& x, K u, V e) {
   V sumw = V(); a.clear();
   x.forEachEdge(u, [&](auto v, auto w) {
     labelsetCombineU(a, ls[v], w);
     sumw += w;
   });
-  labelsetReorderU(a);
+  labelsetReorderU(a, labelsetCapacity(as[u]));
   labelsetCopyW(as[u], a);
   labelsetMultiplyPowU(as[u], 1/sumw, e);
 }
@@ -75,41 +79,231 @@ bool labelrankIsVertexStable(const B& ls, const G& x, K u, V q) {
 
 
 
-template <size_t N, class G>
-auto labelrankSeq(const G& x, const LabelrankOptions& o={}) {
+/**
+ * Find the most probable label of each vertex.
+ * @param x original graph
+ * @param ls labelsets
+ * @returns membership of each vertex
+ */
+template <class G, class L>
+auto labelrankMembership(const G& x, const vector<L>& ls) {
+  using K = typename G::key_type;
+  vector<K> a(x.span());
+  x.forEachVertexKey([&](auto u) { a[u] = labelsetFirstKey(ls[u]); });
+  return a;
+}
+
+
+/**
+ * Iterate labelsets until convergence, only updating unstable affected vertices.
+ * When the keys of a vertex change, its neighbours are marked as affected for
+ * the next iteration, so that a change can spread beyond the initially affected
+ * vertices (the graph must be symmetric, for these to include all its
+ * in-neighbours). Stability depends only on keys, so other neighbours need not
+ * be marked.
+ * @param us number of vertices updated in each iteration (output)
+ * @param ts time taken by each iteration [ms] (output)
+ * @param ls current labelsets (updated)
+ * @param ms scratch labelsets
+ * @param la accumulator labelset (scratch)
+ * @param x original graph
+ * @param o labelrank options
+ * @param fa is vertex affected (u)?
+ * @param fp mark vertex as affected (u)
+ */
+template <class G, class A, class L, class FA, class FP>
+void labelrankSeqLoopU(vector<size_t>& us, vector<float>& ts, vector<L>& ls, vector<L>& ms, A& la, const G& x, const LabelrankOptions& o, FA fa, FP fp) {
   using K = typename G::key_type;
   using V = typename G::edge_value_type;
-  ALabelset<K, V> la(x.span());
-  vector<Labelset<K, V, N>> ls(x.span());
-  vector<Labelset<K, V, N>> ms(x.span());
-  auto t0 = timeNow();
-  x.forEachVertexKey([&](auto u) {
-    labelrankInitializeVertexW(la, ls, x, u, V(o.inflation));
-  });
-  auto t1 = timeNow();
-  auto d0 = durationMilliseconds(t0, t1);
-  printf("init_time: %fms\n", d0);
-  int i = 0;
+  vector<K> vnew;
+  us.clear(); ts.clear();
   size_t updatedPrev = 0;
-  while (true) {
+  while (int(us.size())<o.maxIterations) {
+    auto t0 = timeNow();
     size_t updated = 0;
-    auto t2 = timeNow();
+    auto fm = [&](auto v) { if (!fa(v)) vnew.push_back(v); };
     x.forEachVertexKey([&](auto u) {
-      if (labelrankIsVertexStable(ls, x, u, o.conditionalUpdate)) ms[u] = ls[u];
-      else { labelrankUpdateVertexW(la, ms, ls, x, u, o.inflation); updated++; }
-    }); i++;
-    auto t3 = timeNow();
-    auto d2 = durationMilliseconds(t2, t3);
-    printf("i: %d, updated: %zu, time: %fms\n", i, updated, d2);
+      if (!fa(u) || labelrankIsVertexStable(ls, x, u, o.conditionalUpdate)) ms[u] = ls[u];
+      else {
+        labelrankUpdateVertexW(la, ms, ls, x, u, V(o.inflation)); updated++;
+        if (!labelsetHasSameKeys(ms[u], ls[u])) x.forEachEdgeKey(u, fm);
+      }
+    });
+    for (K v : vnew)
+      fp(v);
+    vnew.clear();
     swap(ls, ms);
+    us.push_back(updated);
+    ts.push_back(durationMilliseconds(t0, timeNow()));
     if (!updated || updated==updatedPrev) break;
     updatedPrev = updated;
   }
-  vector<K> a(x.span()); size_t zeros = 0;
-  x.forEachVertexKey([&](auto u) {
-    a[u] = ls[u][0].first;
-    if (a[u]==0) ++zeros;
-  });
-  printf("zeros: %zu\n", zeros);
-  return LabelrankResult(a, i, 0);
+}
+
+
+
+/**
+ * Iterate labelsets until convergence, only examining the active vertices.
+ * A vertex is active if it was updated in the previous iteration, or if the
+ * keys of any of its neighbours changed (stability depends only on keys, so
+ * it cannot have changed for other vertices). Updated labelsets are copied
+ * back, stable labelsets are left in place.
+ * The graph must be symmetric: stability of a vertex depends on its
+ * out-neighbours, but the frontier is expanded to out-neighbours of changed
+ * vertices (which are then also its in-neighbours).
+ * @param us number of vertices updated in each iteration (output)
+ * @param ts time taken by each iteration [ms] (output)
+ * @param ls current labelsets (updated)
+ * @param ms scratch labelsets
+ * @param la accumulator labelset (scratch)
+ * @param x original graph
+ * @param o labelrank options
+ * @param fa is vertex initially affected (u)?
+ */
+template <class G, class A, class L, class FA>
+void labelrankSeqFrontierLoopU(vector<size_t>& us, vector<float>& ts, vector<L>& ls, vector<L>& ms, A& la, const G& x, const LabelrankOptions& o, FA fa) {
+  using K = typename G::key_type;
+  using V = typename G::edge_value_type;
+  vector<K> vupd, vact, vnxt;
+  vector<bool> vnext(x.span());
+  us.clear(); ts.clear();
+  x.forEachVertexKey([&](auto u) { if (fa(u)) vact.push_back(u); });
+  size_t updatedPrev = 0;
+  while (int(us.size())<o.maxIterations) {
+    auto t0 = timeNow();
+    vupd.clear();
+    for (K u : vact) {
+      if (labelrankIsVertexStable(ls, x, u, o.conditionalUpdate)) continue;
+      labelrankUpdateVertexW(la, ms, ls, x, u, V(o.inflation));
+      vupd.push_back(u);
+    }
+    vnxt.clear();
+    auto fm = [&](auto v) {
+      if (vnext[v]) return;
+      vnext[v] = true;
+      vnxt.push_back(v);
+    };
+    for (K u : vupd) {
+      bool changed = !labelsetHasSameKeys(ms[u], ls[u]);
+      ls[u] = ms[u];
+      fm(u);
+      if (changed) x.forEachEdgeKey(u, fm);
+    }
+    for (K u : vnxt)
+      vnext[u] = false;
+    swap(vact, vnxt);
+    size_t updated = vupd.size();
+    us.push_back(updated);
+    ts.push_back(durationMilliseconds(t0, timeNow()));
+    if (!updated || updated==updatedPrev) break;
+    updatedPrev = updated;
+  }
+}
+
+
+
+
+// LABELRANK-SEQ
+// -------------
+
+/**
+ * Find communities in a graph using LabelRank, starting from scratch.
+ * @param ls labelsets (output, can be used for a later dynamic run)
+ * @param x original graph
+ * @param o labelrank options
+ * @returns membership of each vertex, iterations performed, and time taken (averaged over repeats)
+ */
+template <tclass2 A=ALabelset, class G, class L>
+auto labelrankSeqW(vector<L>& ls, const G& x, const LabelrankOptions& o={}) {
+  using K = typename G::key_type;
+  using V = typename G::edge_value_type;
+  auto la = accumulatorLabelset<A, K, V>(x.span());
+  vector<L> ms(x.span());
+  vector<size_t> us;
+  vector<float> ts, tis, tls;
+  auto fa = [](auto u) { return true; };
+  auto fp = [](auto u) {};
+  for (int r=0; r<o.repeat; ++r) {
+    ls.assign(x.span(), L());
+    auto t0 = timeNow();
+    x.forEachVertexKey([&](auto u) {
+      labelrankInitializeVertexW(la, ls, x, u, V(o.inflation));
+    });
+    auto t1 = timeNow();
+    o.frontier? labelrankSeqFrontierLoopU(us, ts, ls, ms, la, x, o, fa) : labelrankSeqLoopU(us, ts, ls, ms, la, x, o, fa, fp);
+    auto t2 = timeNow();
+    tis.push_back(durationMilliseconds(t0, t1));
+    tls.push_back(durationMilliseconds(t1, t2));
+  }
+  return LabelrankResult<K>(labelrankMembership(x, ls), move(us), move(ts), move(tis), move(tls));
+}
+
+
+/**
+ * Find communities in a graph using LabelRank, starting from scratch.
+ * @param x original graph
+ * @param o labelrank options
+ * @returns membership of each vertex, iterations performed, and time taken (averaged over repeats)
+ */
+template <size_t N, tclass2 A=ALabelset, class G>
+auto labelrankSeq(const G& x, const LabelrankOptions& o={}) {
+  using K = typename G::key_type;
+  using V = typename G::edge_value_type;
+  vector<Labelset<K, V, N>> ls;
+  return labelrankSeqW<A>(ls, x, o);
+}
+
+
+
+
+// LABELRANK-SEQ-DYNAMIC
+// ---------------------
+
+/**
+ * Find communities in an updated graph using LabelRank, starting from previous labelsets.
+ * The endpoints of changed edges and their neighbours are initially marked as
+ * affected, and neighbours of updated vertices are marked as they change. All
+ * other vertices retain their previous labelsets.
+ * @param ls previous labelsets (updated)
+ * @param x updated graph
+ * @param deletions edges deleted in this batch (u, v)
+ * @param insertions edges inserted in this batch (u, v)
+ * @param o labelrank options
+ * @returns membership of each vertex, iterations performed, and time taken (averaged over repeats)
+ */
+template <tclass2 A=ALabelset, class G, class L, class K>
+auto labelrankSeqDynamic(vector<L>& ls, const G& x, const vector<tuple<K, K>>& deletions, const vector<tuple<K, K>>& insertions, const LabelrankOptions& o={}) {
+  using V = typename G::edge_value_type;
+  auto la = accumulatorLabelset<A, K, V>(x.span());
+  vector<L> ms(x.span());
+  vector<bool> vaff(x.span());
+  vector<size_t> us;
+  vector<float> ts, tis, tls;
+  ls.resize(x.span());
+  // Each repeat starts from the same previous labelsets.
+  vector<L> ps = o.repeat>1? ls : vector<L>();
+  auto fm = [&](auto u) {
+    if (!x.hasVertex(u)) return;
+    vaff[u] = true;
+    x.forEachEdgeKey(u, [&](auto v) { vaff[v] = true; });
+  };
+  auto fa = [&](auto u) { return bool(vaff[u]); };
+  auto fp = [&](auto u) { vaff[u] = true; };
+  for (int r=0; r<o.repeat; ++r) {
+    if (r>0) { ls = ps; vaff.assign(x.span(), false); }
+    auto t0 = timeNow();
+    for (const auto& [u, v] : deletions)  { fm(u); fm(v); }
+    for (const auto& [u, v] : insertions) { fm(u); fm(v); }
+    x.forEachVertexKey([&](auto u) {
+      if (labelsetFirstKey(ls[u])) return;
+      labelrankInitializeVertexW(la, ls, x, u, V(o.inflation));
+      vaff[u] = true;
+    });
+    auto t1 = timeNow();
+    o.frontier? labelrankSeqFrontierLoopU(us, ts, ls, ms, la, x, o, fa) : labelrankSeqLoopU(us, ts, ls, ms, la, x, o, fa, fp);
+    auto t2 = timeNow();
+    tis.push_back(durationMilliseconds(t0, t1));
+    tls.push_back(durationMilliseconds(t1, t2));
+  }
+  return LabelrankResult<K>(labelrankMembership(x, ls), move(us), move(ts), move(tis), move(tls));
 }
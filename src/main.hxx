@@ -2,6 +2,7 @@
 #include "_main.hxx"
 #include "Graph.hxx"
 #include "mtx.hxx"
+#include "binary.hxx"
 #include "snap.hxx"
 #include "vertices.hxx"
 #include "edges.hxx"
@@ -11,7 +12,10 @@
 #include "symmetricize.hxx"
 #include "selfLoop.hxx"
 #include "deadEnds.hxx"
+#include "update.hxx"
 #include "properties.hxx"
 #include "modularity.hxx"
 #include "labelrank.hxx"
 #include "labelrankSeq.hxx"
+#include "labelrankOmp.hxx"
+#include "benchmark.hxx"
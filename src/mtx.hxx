@@ -4,8 +4,13 @@
 #include <sstream>
 #include <fstream>
 #include <algorithm>
+#include <utility>
+#include <tuple>
+#include <vector>
+#include <omp.h>
 #include "_main.hxx"
 #include "Graph.hxx"
+#include "csr.hxx"
 
 using std::string;
 using std::istream;
@@ -13,6 +18,13 @@ using std::stringstream;
 using std::ofstream;
 using std::getline;
 using std::max;
+using std::pair;
+using std::tuple;
+using std::vector;
+using std::sort;
+using std::unique;
+using std::stable_sort;
+using std::move;
 
 
 
@@ -90,6 +102,170 @@ READ_MTX_RETURN(Graph, false)
 
 
 
+
+// READ-MTX-OMP
+// ------------
+
+/**
+ * Read header of a matrix market file.
+ * @param rows number of rows (output)
+ * @param cols number of columns (output)
+ * @param size number of entries (output)
+ * @param sym is matrix symmetric (output)
+ * @param weighted does each entry have a value (output)
+ * @param x begin of text
+ * @param xe end of text
+ * @returns pointer to first entry, or nullptr if not a coordinate matrix
+ */
+inline const char* readMtxHeaderW(size_t& rows, size_t& cols, size_t& size, bool& sym, bool& weighted, const char *x, const char *xe) {
+  string h0, h1, h2, h3, h4;
+  for (; x<xe && *x=='%'; x=skipLine(x, xe)) {
+    if (xe-x<2 || x[1]!='%') continue;
+    stringstream ls(string(x, skipLine(x, xe)));
+    ls >> h0 >> h1 >> h2 >> h3 >> h4;
+  }
+  if (h1!="matrix" || h2!="coordinate") return nullptr;
+  sym = h4=="symmetric" || h4=="skew-symmetric";
+  weighted = h3!="pattern";
+  if (!(x = readWholeNumberW(rows, x, xe))) return nullptr;
+  if (!(x = readWholeNumberW(cols, x, xe))) return nullptr;
+  if (!(x = readWholeNumberW(size, x, xe))) return nullptr;
+  return skipLine(x, xe);
+}
+
+
+/**
+ * Read entries of a matrix market file, in a given chunk of text.
+ * Only lines beginning within the chunk are read.
+ * @param a read edges (u, v, w) (output)
+ * @param x begin of chunk
+ * @param xe end of chunk
+ * @param te end of text
+ * @param weighted does each entry have a value
+ * @param S span of vertices (entries outside [1, S) are skipped)
+ */
+template <class K, class E>
+void readMtxChunkW(vector<tuple<K, K, E>>& a, const char *x, const char *xe, const char *te, bool weighted, size_t S) {
+  while (x<xe) {
+    const char *p = x;
+    size_t u, v; double w = 1;
+    x = skipLine(x, te);
+    if (*p=='%') continue;
+    if (!(p = readWholeNumberW(u, p, te))) continue;
+    if (!(p = readWholeNumberW(v, p, te))) continue;
+    if (u<1 || u>=S || v<1 || v>=S) continue;
+    if (weighted) readFloatW(w, p, te);
+    a.push_back({K(u), K(v), E(w)});
+  }
+}
+
+
+/**
+ * Read a matrix market file into a CSR graph, in parallel.
+ * The file is memory-mapped, split into chunks at line boundaries, and
+ * each chunk is parsed independently. Duplicate edges are removed, and
+ * entries outside the dimensions given in the header are skipped.
+ * @param a output graph
+ * @param pth path to file
+ * @param sym add reverse of each edge (symmetricize)?
+ * @param loop add self-loop (of unit weight) to each vertex?
+ * @returns true if file was read
+ */
+template <class K, class E, class O>
+bool readMtxOmpW(CsrGraph<K, E, O>& a, const char *pth, bool sym=false, bool loop=false) {
+  MappedFile f(pth);
+  if (!f.valid()) return false;
+  f.adviseSequential();
+  const char *xb = f.begin(), *xe = f.end();
+  size_t rows, cols, size; bool fsym, weighted;
+  if (!(xb = readMtxHeaderW(rows, cols, size, fsym, weighted, xb, xe))) return false;
+  size_t S = max(rows, cols) + 1;
+  size_t C = 4 * omp_get_max_threads();
+  size_t L = xe - xb;
+  sym |= fsym;
+  // Parse entries in chunks.
+  vector<vector<tuple<K, K, E>>> es(C);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t i=0; i<C; ++i) {
+    const char *cb = xb + i*L/C;
+    const char *ce = xb + (i+1)*L/C;
+    if (i>0 && *(cb-1)!='\n') cb = skipLine(cb, xe);
+    es[i].reserve(size/C + 1);
+    readMtxChunkW(es[i], cb, ce, xe, weighted, S);
+  }
+  // Count degree of each vertex.
+  vector<O> degs(S);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t i=0; i<C; ++i) {
+    for (const auto& [u, v, w] : es[i]) {
+      #pragma omp atomic
+      ++degs[u];
+      if (!sym || u==v) continue;
+      #pragma omp atomic
+      ++degs[v];
+    }
+  }
+  if (loop) {
+    #pragma omp parallel for schedule(static, 2048)
+    for (size_t u=1; u<S; ++u)
+      ++degs[u];
+  }
+  // Scatter edges to their source vertices.
+  vector<O> offs(S+1);
+  for (size_t u=0; u<S; ++u)
+    offs[u+1] = offs[u] + degs[u];
+  vector<O> poss(offs.begin(), offs.end()-1);
+  vector<pair<K, E>> buf(offs[S]);
+  #pragma omp parallel for schedule(dynamic, 1)
+  for (size_t i=0; i<C; ++i) {
+    for (const auto& [u, v, w] : es[i]) {
+      O j;
+      #pragma omp atomic capture
+      j = poss[u]++;
+      buf[j] = {v, w};
+      if (!sym || u==v) continue;
+      #pragma omp atomic capture
+      j = poss[v]++;
+      buf[j] = {u, w};
+    }
+    vector<tuple<K, K, E>>().swap(es[i]);
+  }
+  if (loop) {
+    #pragma omp parallel for schedule(static, 2048)
+    for (size_t u=1; u<S; ++u)
+      buf[poss[u]++] = {K(u), E(1)};
+  }
+  // Sort edges of each vertex, and remove duplicates.
+  auto fl = [](const auto& p, const auto& q) { return p.first <  q.first; };
+  auto fe = [](const auto& p, const auto& q) { return p.first == q.first; };
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (size_t u=0; u<S; ++u) {
+    auto ib = buf.begin() + offs[u];
+    auto ie = buf.begin() + offs[u+1];
+    stable_sort(ib, ie, fl);
+    degs[u] = unique(ib, ie, fe) - ib;
+  }
+  // Compact edges into CSR.
+  vector<O> offsets(S+1);
+  for (size_t u=0; u<S; ++u)
+    offsets[u+1] = offsets[u] + degs[u];
+  vector<K> targets(offsets[S]);
+  vector<E> weights(offsets[S]);
+  #pragma omp parallel for schedule(dynamic, 2048)
+  for (size_t u=0; u<S; ++u) {
+    for (O i=0; i<degs[u]; ++i) {
+      targets[offsets[u]+i] = buf[offs[u]+i].first;
+      weights[offsets[u]+i] = buf[offs[u]+i].second;
+    }
+  }
+  vector<bool> vexists(S, true); vexists[0] = false;
+  a = CsrGraph<K, E, O>(move(vexists), move(offsets), move(targets), move(weights));
+  return true;
+}
+
+
+
+
 // WRITE-MTX
 // ---------
 
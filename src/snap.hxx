@@ -3,12 +3,16 @@
 #include <vector>
 #include <istream>
 #include <sstream>
+#include <tuple>
+#include "_string.hxx"
 
 using std::string;
 using std::vector;
 using std::istream;
 using std::stringstream;
 using std::getline;
+using std::tuple;
+using std::get;
 
 
 
@@ -35,3 +39,37 @@ bool readSnapTemporalW(G& a, istream& s, size_t N, bool sym=false) {
   a.correct();
   return i>0;
 }
+
+
+
+
+
+// READ-SNAP-TEMPORAL-BATCH
+// ------------------------
+
+/**
+ * Read a batch of temporal edges, limited by edge count and/or time window.
+ * Lines that are not edges (comments, blank lines) are skipped.
+ * @param a read edges (u, v, t) (output)
+ * @param s input stream (seekable, if time window is used)
+ * @param N maximum number of edges in batch (0 => no limit)
+ * @param W time window of batch, from its first edge (0 => no limit)
+ * @returns true if any edge was read
+ */
+template <class K, class T>
+bool readSnapTemporalBatchW(vector<tuple<K, K, T>>& a, istream& s, size_t N, T W=T()) {
+  string ln; a.clear();
+  while (!N || a.size()<N) {
+    // Only remember the line position if it may need to be pushed back.
+    auto p = W? s.tellg() : decltype(s.tellg())(-1);
+    if (!getline(s, ln)) break;
+    K u, v; T t;
+    const char *x = ln.data(), *xe = x + ln.size();
+    if (!(x = readWholeNumberW(u, x, xe))) continue;
+    if (!(x = readWholeNumberW(v, x, xe))) continue;
+    if (!(x = readWholeNumberW(t, x, xe))) continue;
+    if (W && !a.empty() && t >= get<2>(a[0]) + W) { s.seekg(p); break; }
+    a.push_back({u, v, t});
+  }
+  return !a.empty();
+}
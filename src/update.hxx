@@ -0,0 +1,94 @@
+#pragma once
+#include <tuple>
+#include <vector>
+#include <random>
+#include "_main.hxx"
+
+using std::tuple;
+using std::vector;
+using std::uniform_int_distribution;
+
+
+
+
+// RANDOM-EDGE-DELETIONS
+// ---------------------
+
+/**
+ * Pick a batch of random (non self-loop) edges to delete.
+ * @param rnd random number generator
+ * @param x original graph
+ * @param batchSize number of edges to pick
+ * @returns deleted edges (u, v)
+ */
+template <class R, class G>
+auto randomEdgeDeletions(R& rnd, const G& x, size_t batchSize) {
+  using K = typename G::key_type;
+  vector<tuple<K, K>> a;
+  if (x.span()<2) return a;
+  uniform_int_distribution<K> dis(K(), x.span()-1);
+  for (size_t i=0, retries=0; i<batchSize && retries<100*batchSize; ++retries) {
+    K u = dis(rnd), d = x.degree(u);
+    if (!x.hasVertex(u) || d==0) continue;
+    uniform_int_distribution<K> die(K(), d-1);
+    K j = die(rnd), v = K(), k = K();
+    x.forEachEdgeKey(u, [&](auto w) { if (k++==j) v = w; });
+    if (u==v) continue;
+    a.push_back({u, v}); ++i;
+  }
+  return a;
+}
+
+
+
+
+// RANDOM-EDGE-INSERTIONS
+// ----------------------
+
+/**
+ * Pick a batch of random (non self-loop) edges to insert.
+ * @param rnd random number generator
+ * @param x original graph
+ * @param batchSize number of edges to pick
+ * @returns inserted edges (u, v)
+ */
+template <class R, class G>
+auto randomEdgeInsertions(R& rnd, const G& x, size_t batchSize) {
+  using K = typename G::key_type;
+  vector<tuple<K, K>> a;
+  if (x.span()<2) return a;
+  uniform_int_distribution<K> dis(K(), x.span()-1);
+  for (size_t i=0, retries=0; i<batchSize && retries<100*batchSize; ++retries) {
+    K u = dis(rnd), v = dis(rnd);
+    if (!x.hasVertex(u) || !x.hasVertex(v)) continue;
+    if (u==v || x.hasEdge(u, v)) continue;
+    a.push_back({u, v}); ++i;
+  }
+  return a;
+}
+
+
+
+
+// UPDATE-GRAPH
+// ------------
+
+/**
+ * Apply a batch of edge deletions and insertions to an undirected graph.
+ * @param a graph to update (symmetric)
+ * @param deletions edges to delete (u, v)
+ * @param insertions edges to insert (u, v)
+ * @param w weight of inserted edges
+ */
+template <class G, class K, class E>
+void updateGraphU(G& a, const vector<tuple<K, K>>& deletions, const vector<tuple<K, K>>& insertions, E w) {
+  for (const auto& [u, v] : deletions) {
+    a.removeEdge(u, v);
+    a.removeEdge(v, u);
+  }
+  for (const auto& [u, v] : insertions) {
+    a.addEdge(u, v, w);
+    a.addEdge(v, u, w);
+  }
+  a.correct();
+}